@@ -0,0 +1,66 @@
+#include <chrono>
+#include <iostream>
+#include <string>
+
+#include "BatchEngine.h"
+#include "Strategy.h"
+
+/**
+ * Plays every pairing of the built-in strategies 'matches' times, once with the scalar game kernel
+ * (playMatch, one round at a time through the same payoff table as GameSession::updateScores) and once with
+ * the bit-parallel BatchEngine, and prints matches per second of both.
+ * Without noise every deterministic pairing must give exactly the same average on both paths, which is checked too.
+ *
+ * Usage: BatchEngineBenchmark [matchesPerPairing = 100000] [rounds = 200] [noise = 0]
+ */
+int main(int argc, char* argv[]) {
+    const int matches = argc > 1 ? std::stoi(argv[1]) : 100000;
+    const int rounds = argc > 2 ? std::stoi(argv[2]) : 200;
+    const double noise = argc > 3 ? std::stod(argv[3]) : 0.0;
+
+    const auto scalarStrategies = builtinStrategies();
+    const auto tables = builtinMemoryOneStrategies();
+    const BatchEngine engine(rounds, noise);
+    const int batches = (matches + BatchEngine::LANES - 1) / BatchEngine::LANES;
+
+    double scalarSeconds = 0;
+    double batchSeconds = 0;
+    long long scalarMatches = 0;
+    long long batchMatches = 0;
+    int mismatches = 0;
+    for (size_t i = 0; i < tables.size(); i++) {
+        for (size_t j = i; j < tables.size(); j++) {
+            const auto first = scalarStrategies[i]->clone();
+            const auto second = scalarStrategies[j]->clone();
+            long long scalarCoins = 0;
+            auto start = std::chrono::steady_clock::now();
+            for (int m = 0; m < matches; m++) {
+                scalarCoins += playMatch(*first, *second, rounds, m).score1;
+            }
+            scalarSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            scalarMatches += matches;
+
+            long long batchCoins = 0;
+            start = std::chrono::steady_clock::now();
+            for (int b = 0; b < batches; b++) {
+                batchCoins += engine.playBatch(tables[i], tables[j], b * 0x9e3779b97f4a7c15ULL).score1;
+            }
+            batchSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            batchMatches += (long long)batches * BatchEngine::LANES;
+
+            const double scalarAverage = (double)scalarCoins / ((double)matches * rounds);
+            const double batchAverage = (double)batchCoins / ((double)batches * BatchEngine::LANES * rounds);
+            const bool deterministic = tables[i].name != "Random" && tables[j].name != "Random" && noise == 0;
+            if (deterministic && scalarAverage != batchAverage) {
+                mismatches++;
+            }
+            std::cout << tables[i].name << " vs " << tables[j].name << ": scalar " << scalarAverage
+                      << ", batch " << batchAverage << std::endl;
+        }
+    }
+
+    std::cout << "scalar: " << (long long)(scalarMatches / scalarSeconds) << " matches/s" << std::endl;
+    std::cout << "batch:  " << (long long)(batchMatches / batchSeconds) << " matches/s" << std::endl;
+    std::cout << "deterministic pairings which disagree: " << mismatches << std::endl;
+    return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,88 @@
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "AuthHandler.h"
+#include "LengthChecker.h"
+#include "SqliteUserDao.h"
+#include "InMemoryUserDao.h"
+
+/**
+ * Login storm: 'threads' clients log in 'loginsPerThread' times each, as it happens when every client
+ * reconnects after a deploy. Runs the storm twice, once with every AuthHandler call behind a single global mutex
+ * (how ServerAuthenticator used to work) and once fully concurrent, and prints logins per second for both.
+ *
+ * Passwords are hashed with a cheap 'hashIterations' cost, so the numbers show the locking and storage overhead
+ * rather than PBKDF2 itself.
+ *
+ * Usage: LoginStormBenchmark [sqlite|memory] [threads] [loginsPerThread] [hashIterations]
+ */
+namespace {
+    double runStorm(const AuthHandler& authHandler, const int threads, const int loginsPerThread,
+                    const int users, std::mutex* globalMutex) {
+        std::atomic<int> failures = 0;
+        std::vector<std::thread> clients;
+        const auto start = std::chrono::steady_clock::now();
+        for (int t = 0; t < threads; t++) {
+            clients.emplace_back([&, t]() {
+                for (int i = 0; i < loginsPerThread; i++) {
+                    const std::string username = "user" + std::to_string((t * loginsPerThread + i) % users);
+                    std::unique_lock<std::mutex> lock;
+                    if (globalMutex != nullptr) {
+                        lock = std::unique_lock<std::mutex>(*globalMutex);
+                    }
+                    if (authHandler.loginUser(username, "Password1").second == 0) {
+                        ++failures;
+                    }
+                }
+            });
+        }
+        for (auto& client : clients) {
+            client.join();
+        }
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        if (failures != 0) {
+            std::cerr << failures << " logins failed" << std::endl;
+        }
+        return threads * loginsPerThread / elapsed.count();
+    }
+}
+
+int main(int argc, char* argv[]) {
+    const std::string store = argc > 1 ? argv[1] : "sqlite";
+    const int threads = argc > 2 ? std::stoi(argv[2]) : 8;
+    const int loginsPerThread = argc > 3 ? std::stoi(argv[3]) : 20000;
+    const int hashIterations = argc > 4 ? std::stoi(argv[4]) : 1;
+    constexpr int users = 1000;
+
+    const auto dbPath = std::filesystem::temp_directory_path() / "login_storm.sqlite";
+    std::filesystem::remove(dbPath);
+
+    std::shared_ptr<UserDAO> userDao;
+    if (store == "memory") {
+        userDao = std::make_shared<InMemoryUserDAO>();
+    } else {
+        userDao = std::make_shared<SqliteUserDAO>(std::make_shared<Database>(dbPath.string()));
+    }
+    const auto hashingPool = std::make_shared<HashingPool>(threads, threads * 4);
+    const AuthHandler authHandler(userDao, std::make_shared<LengthChecker>(8),
+                                  std::make_shared<PasswordHasher>(hashIterations), hashingPool);
+    for (int i = 0; i < users; i++) {
+        (void)authHandler.registerUser("user" + std::to_string(i), "Password1", "Password1");
+    }
+
+    std::mutex globalMutex;
+    const double serialized = runStorm(authHandler, threads, loginsPerThread, users, &globalMutex);
+    const double concurrent = runStorm(authHandler, threads, loginsPerThread, users, nullptr);
+    std::cout << store << ", " << threads << " threads" << std::endl;
+    std::cout << "global mutex: " << (long long)serialized << " logins/s" << std::endl;
+    std::cout << "concurrent:   " << (long long)concurrent << " logins/s" << std::endl;
+    std::cout << "rejected by hashing pool: " << hashingPool->getMetrics().rejected << std::endl;
+    return 0;
+}
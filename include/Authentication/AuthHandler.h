@@ -3,6 +3,8 @@
 
 #include "UserDao.h"
 #include "PasswordChecker.h"
+#include "PasswordHasher.h"
+#include "HashingPool.h"
 #include <memory>
 
 /**
@@ -10,19 +12,25 @@
  * It has a chain of 'passwordChecker's in order to suggest user a stronger password options.
  * Also, it has 'userDao' object to ensure that all new users are added to the Database
  * and the passwords during login phase are correct
+ * Passwords are stored as 'passwordHasher' hashes, all hashing runs on 'hashingPool'.
+ * When the pool is overloaded, login and registration are refused with a "busy" message.
  */
 class AuthHandler {
 public:
-    AuthHandler(std::shared_ptr<UserDAO> dao, std::shared_ptr<PasswordChecker> checker);
+    AuthHandler(std::shared_ptr<UserDAO> dao, std::shared_ptr<PasswordChecker> checker,
+                std::shared_ptr<PasswordHasher> hasher, std::shared_ptr<HashingPool> pool);
     ~AuthHandler() = default;
 
-    [[nodiscard]] std::string loginUser(const std::string& username, const std::string& password) const;
+    [[nodiscard]] std::pair<std::string, int> loginUser(const std::string& username, const std::string& password) const;
     [[nodiscard]] std::string registerUser(const std::string& username,
         const std::string& password, const std::string& repeated_password) const;
+    [[nodiscard]] std::string usernameOf(int userId) const;
 
 private:
     std::shared_ptr<UserDAO> userDao;
     std::shared_ptr<PasswordChecker> passwordChecker;
+    std::shared_ptr<PasswordHasher> passwordHasher;
+    std::shared_ptr<HashingPool> hashingPool;
 };
 
 #endif //AUTHHANDLER_H
@@ -0,0 +1,48 @@
+#ifndef CACHEDUSERDAO_H
+#define CACHEDUSERDAO_H
+
+#include <array>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include "UserDao.h"
+
+/**
+ * Read-through cache in front of another UserDAO, so reconnect storms are answered from memory.
+ * 'getUserByName' results are kept in a bounded LRU ('capacity' entries in total, split between 'SHARDS'
+ * independently locked shards). Names which do not exist are cached too (as 'default' User objects).
+ * 'addUser' and 'updatePassword' go to 'userDao' and then drop the cached entry of the name.
+ *
+ * Every shard has a version which is bumped on each write, a lookup which raced with a write
+ * does not put its (possibly stale) result into the cache.
+ */
+class CachedUserDAO final : public UserDAO {
+public:
+    CachedUserDAO(std::shared_ptr<UserDAO> userDao, size_t capacity);
+    ~CachedUserDAO() override = default;
+
+    [[nodiscard]] User getUserByName(const std::string& username) const override;
+    [[nodiscard]] User getUserById(int id) const override;
+    int addUser(const User& user) const override;
+    void updatePassword(int id, const std::string& password) const override;
+
+private:
+    static constexpr size_t SHARDS = 16;
+
+    struct Shard {
+        std::mutex mutex;
+        std::list<User> entries;
+        std::unordered_map<std::string, std::list<User>::iterator> index;
+        unsigned long long version = 0;
+    };
+
+    Shard& shardOf(const std::string& username) const;
+    void store(Shard& shard, const std::string& username, const User& user) const;
+
+    std::shared_ptr<UserDAO> userDao;
+    size_t capacityPerShard;
+    mutable std::array<Shard, SHARDS> shards;
+};
+
+#endif //CACHEDUSERDAO_H
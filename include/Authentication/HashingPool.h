@@ -0,0 +1,79 @@
+#ifndef HASHINGPOOL_H
+#define HASHINGPOOL_H
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+#include <condition_variable>
+
+/**
+ * Small fixed pool of worker threads which runs expensive password hashing away from client and game threads.
+ * The queue is bounded by 'maxQueueDepth': when it is full, 'trySubmit' rejects the job immediately
+ * instead of queueing it, so a login storm ends up in fast "server is busy" answers rather than
+ * in every thread of the server waiting for hashing.
+ *
+ * Metrics describe how long jobs waited in the queue and how long they ran (hash latency).
+ */
+class HashingPool {
+public:
+    struct Metrics {
+        long long completed;
+        long long rejected;
+        int queueDepth;
+        int peakQueueDepth;
+        double averageWaitMs;
+        double averageRunMs;
+        double maxRunMs;
+    };
+
+    HashingPool(int threads, int maxQueueDepth);
+    ~HashingPool();
+
+    /**
+     * Queues 'job' and returns future of its result, or nothing if the queue is full or the pool is stopping
+     */
+    template <typename Job>
+    std::optional<std::future<std::invoke_result_t<Job>>> trySubmit(Job job) {
+        auto task = std::make_shared<std::packaged_task<std::invoke_result_t<Job>()>>(std::move(job));
+        auto future = task->get_future();
+        if (!tryPush([task]() { (*task)(); })) {
+            return std::nullopt;
+        }
+        return future;
+    }
+
+    [[nodiscard]] Metrics getMetrics() const;
+
+private:
+    struct QueuedJob {
+        std::function<void()> job;
+        std::chrono::steady_clock::time_point queuedAt;
+    };
+
+    bool tryPush(std::function<void()> job);
+    void workerLoop();
+
+    int maxQueueDepth;
+    std::vector<std::thread> workers;
+
+    mutable std::mutex queueMutex;
+    std::condition_variable cvQueue;
+    std::deque<QueuedJob> queue;
+    bool stopping = false;
+
+    std::atomic<long long> completed{0};
+    std::atomic<long long> rejected{0};
+    std::atomic<int> peakQueueDepth{0};
+    std::atomic<long long> totalWaitNs{0};
+    std::atomic<long long> totalRunNs{0};
+    std::atomic<long long> maxRunNs{0};
+};
+
+#endif //HASHINGPOOL_H
@@ -0,0 +1,40 @@
+#ifndef INMEMORYUSERDAO_H
+#define INMEMORYUSERDAO_H
+
+#include <array>
+#include <atomic>
+#include <shared_mutex>
+#include <unordered_map>
+#include "UserDao.h"
+
+/**
+ * UserDAO which keeps users only in memory, used to measure the server without any disk I/O.
+ * Users are spread over 'SHARDS' independent maps (once by username and once by id),
+ * each guarded by its own reader-writer lock, so lookups of different users do not contend.
+ * Ids are handed out the same way as SQLite does: 1, 2, 3...
+ */
+class InMemoryUserDAO final : public UserDAO {
+public:
+    InMemoryUserDAO() = default;
+    ~InMemoryUserDAO() override = default;
+
+    [[nodiscard]] User getUserByName(const std::string& username) const override;
+    [[nodiscard]] User getUserById(int id) const override;
+    int addUser(const User& user) const override;
+    void updatePassword(int id, const std::string& password) const override;
+
+private:
+    static constexpr size_t SHARDS = 16;
+
+    template <typename Key>
+    struct Shard {
+        mutable std::shared_mutex mutex;
+        std::unordered_map<Key, User> users;
+    };
+
+    mutable std::array<Shard<std::string>, SHARDS> byName;
+    mutable std::array<Shard<int>, SHARDS> byId;
+    mutable std::atomic<int> nextId{1};
+};
+
+#endif //INMEMORYUSERDAO_H
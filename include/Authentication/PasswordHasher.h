@@ -0,0 +1,33 @@
+#ifndef PASSWORDHASHER_H
+#define PASSWORDHASHER_H
+
+#include <array>
+#include <string>
+#include <cstdint>
+
+/**
+ * Turns passwords into salted PBKDF2-HMAC-SHA256 hashes and checks passwords against them.
+ * A stored hash looks like "pbkdf2-sha256$<iterations>$<salt hex>$<hash hex>", so hashes made with
+ * a different 'iterations' count keep working after the cost is changed.
+ *
+ * Hashing is deliberately slow (it is 'iterations' rounds of HMAC), callers should run it on HashingPool
+ * rather than on a client or game thread.
+ */
+class PasswordHasher {
+public:
+    explicit PasswordHasher(int iterations);
+    ~PasswordHasher() = default;
+
+    [[nodiscard]] std::string hash(const std::string& password) const;
+    [[nodiscard]] bool verify(const std::string& password, const std::string& storedHash) const;
+    [[nodiscard]] bool needsRehash(const std::string& storedHash) const;
+    [[nodiscard]] static bool isHash(const std::string& stored);
+
+    static std::array<uint8_t, 32> sha256(const uint8_t* data, size_t size);
+    static std::array<uint8_t, 32> hmacSha256(const std::string& key, const uint8_t* data, size_t size);
+
+private:
+    int iterations;
+};
+
+#endif //PASSWORDHASHER_H
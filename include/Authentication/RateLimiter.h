@@ -0,0 +1,56 @@
+#ifndef RATELIMITER_H
+#define RATELIMITER_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+
+/**
+ * Token bucket rate limiter keyed by an arbitrary string (remote address, username...).
+ * Every key may spend up to 'burst' attempts at once, after that one attempt per 'interval'.
+ *
+ * A bucket is a single atomic "theoretical arrival time" (GCRA), so taking a token is one
+ * compare-and-swap under a shared lock of its shard; the exclusive lock is only needed
+ * the first time a key is seen. Buckets which stayed full for 'idleTimeout' carry no information
+ * and are dropped while their shard is swept, which happens at most once per 'idleTimeout'.
+ * Time is read from 'clock', which only tests replace.
+ */
+class RateLimiter {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    RateLimiter(int burst, std::chrono::microseconds interval,
+                std::chrono::seconds idleTimeout = std::chrono::minutes(10),
+                std::function<Clock::time_point()> clock = Clock::now);
+    ~RateLimiter() = default;
+
+    bool tryAcquire(const std::string& key);
+    [[nodiscard]] size_t size() const;
+
+private:
+    static constexpr size_t SHARDS = 16;
+
+    struct Shard {
+        mutable std::shared_mutex mutex;
+        std::unordered_map<std::string, std::atomic<int64_t>> buckets;
+        int64_t nextSweep = 0;
+    };
+
+    [[nodiscard]] int64_t now() const;
+    bool take(std::atomic<int64_t>& arrival, int64_t time) const;
+    void sweep(Shard& shard, int64_t time) const;
+
+    int64_t interval;
+    int64_t tolerance;
+    int64_t idleTimeout;
+    std::function<Clock::time_point()> clock;
+    Clock::time_point start;
+    std::array<Shard, SHARDS> shards;
+};
+
+#endif //RATELIMITER_H
@@ -5,26 +5,66 @@
 #include <string>
 #include <mutex>
 #include "AuthHandler.h"
+#include "SessionManager.h"
+#include "RateLimiter.h"
+#include "UsernameTable.h"
 #include <unordered_set>
 
 /**
  * This class handles login and registration of a client using authHandler object
- * Uses authMutex so that authHandler method calls are atomically
+ * authHandler and the DAOs behind it are thread-safe, so clients authenticate concurrently.
+ * A successful login claims the username in 'activeUsers' right away, under 'activeUsersMutex'
+ * Every successful login also hands out a session token (see SessionManager), a reconnecting client
+ * can answer the first prompt with "RESUME <token>" to be logged in without the dialogue
+ * Before any work is handed to authHandler, the attempt is charged to the remote address ('addressLimiter')
+ * and, for logins, to the account ('accountLimiter'). A null limiter means no limit
+ * Usernames of logged in clients are interned in 'usernames', 'activeUsers' holds their handles
+ *
+ * 'registerUser', 'login' and 'resume' do the work without talking to the client, so the text dialogue
+ * and the binary protocol (see BinaryProtocol.h) share them and only word the outcome differently
  */
 class ServerAuthenticator {
 public:
-    explicit ServerAuthenticator(std::shared_ptr<AuthHandler> authHandler);
+    /**
+     * Outcome of a login or resume: handle and id of the user who is now logged in (empty handle and id 0 if nobody is),
+     * the message for the client and, after a successful login, the new session token
+     */
+    struct LoginResult {
+        Username username;
+        int userId = 0;
+        std::string message;
+        std::string token = {};
+    };
+
+    inline static const std::string RATE_LIMITED_MESSAGE = "Too many attempts, try again later.\n";
+
+    ServerAuthenticator(std::shared_ptr<AuthHandler> authHandler, std::shared_ptr<SessionManager> sessionManager,
+                        std::shared_ptr<RateLimiter> addressLimiter, std::shared_ptr<RateLimiter> accountLimiter,
+                        std::shared_ptr<UsernameTable> usernames);
     ~ServerAuthenticator() = default;
 
     bool handleRegistration(SOCKET clientSocket);
-    std::string handleLogin(SOCKET clientSocket,
-                            std::mutex& activeUsersMutex, const std::unordered_set<std::string> &activeUsers);
-    std::string loginRegistrationPhase(SOCKET clientSocket,
-                            std::mutex& activeUsersMutex, const std::unordered_set<std::string>& activeUsers);
+    std::pair<Username, int> handleLogin(SOCKET clientSocket,
+                            std::mutex& activeUsersMutex, std::unordered_set<Username>& activeUsers);
+    std::pair<Username, int> handleResume(SOCKET clientSocket, const std::string& token,
+                            std::mutex& activeUsersMutex, std::unordered_set<Username>& activeUsers);
+    std::pair<Username, int> loginRegistrationPhase(SOCKET clientSocket, const std::string& clientAddress,
+                            std::mutex& activeUsersMutex, std::unordered_set<Username>& activeUsers);
+
+    [[nodiscard]] bool allowAttempt(const std::string& clientAddress) const;
+    [[nodiscard]] std::string registerUser(const std::string& username, const std::string& password,
+                                           const std::string& repeatedPassword) const;
+    LoginResult login(const std::string& username, const std::string& password,
+                      std::mutex& activeUsersMutex, std::unordered_set<Username>& activeUsers) const;
+    LoginResult resume(const std::string& token,
+                       std::mutex& activeUsersMutex, std::unordered_set<Username>& activeUsers) const;
 
 private:
-    std::mutex authMutex;
     std::shared_ptr<AuthHandler> authHandler;
+    std::shared_ptr<SessionManager> sessionManager;
+    std::shared_ptr<RateLimiter> addressLimiter;
+    std::shared_ptr<RateLimiter> accountLimiter;
+    std::shared_ptr<UsernameTable> usernames;
 };
 
 #endif //SERVERAUTHENTICATOR_H
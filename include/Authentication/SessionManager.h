@@ -0,0 +1,33 @@
+#ifndef SESSIONMANAGER_H
+#define SESSIONMANAGER_H
+
+#include <chrono>
+#include <string>
+
+/**
+ * Issues and checks signed session tokens, so a client whose connection dropped can resume
+ * with a single line instead of going through the whole login dialogue again.
+ * A token is "<user id>.<expiry>.<signature>" where signature is HMAC-SHA256 of the rest keyed with 'secret'.
+ * Checking a token needs no storage at all, only one HMAC. The username is left out, so "RESUME <token>"
+ * stays within MAX_INPUT_LENGTH whatever the name of the account.
+ *
+ * Tokens survive a server restart only if the same 'secret' is used (see '--session-secret' in main).
+ */
+class SessionManager {
+public:
+    SessionManager(std::string secret, std::chrono::seconds lifetime);
+    ~SessionManager() = default;
+
+    [[nodiscard]] std::string issue(int userId) const;
+    [[nodiscard]] int verify(const std::string& token) const;
+
+    [[nodiscard]] static std::string randomSecret();
+
+private:
+    [[nodiscard]] std::string sign(const std::string& payload) const;
+
+    std::string secret;
+    std::chrono::seconds lifetime;
+};
+
+#endif //SESSIONMANAGER_H
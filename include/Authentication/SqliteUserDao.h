@@ -0,0 +1,28 @@
+#ifndef SQLITEUSERDAO_H
+#define SQLITEUSERDAO_H
+
+#include <string>
+#include <memory>
+#include "Database.h"
+#include "UserDao.h"
+
+/**
+ * DAO class which handles storing and retrieving users in a 'user' table of 'database'.
+ * Connections are borrowed from 'database', which is shared with SqliteMatchDAO
+ * 'user' table consists of three columns: integer 'id', unique 'username' and 'password'
+ */
+class SqliteUserDAO final : public UserDAO {
+public:
+    explicit SqliteUserDAO(std::shared_ptr<Database> database);
+    ~SqliteUserDAO() override = default;
+
+    [[nodiscard]] User getUserByName(const std::string& username) const override;
+    [[nodiscard]] User getUserById(int id) const override;
+    int addUser(const User& user) const override;
+    void updatePassword(int id, const std::string& password) const override;
+
+private:
+    std::shared_ptr<Database> database;
+};
+
+#endif // SQLITEUSERDAO_H
@@ -4,20 +4,23 @@
 #include <string>
 
 /**
- * Simplest class of this project. It is here to store username and password of a client.
+ * Simplest class of this project. It is here to store id, username and password of a client.
+ * 'id' is the integer key assigned by the database, 0 means the user is not stored yet.
  * It is used by UserDao and authHandler to make the code more readable
  */
 class User {
 public:
-    User(std::string username, std::string password);
+    User(std::string username, std::string password, int id = 0);
     ~User() = default;
 
     [[nodiscard]] bool equals(const User& other) const;
 
+    [[nodiscard]] int getId() const;
     [[nodiscard]] std::string getUsername() const;
     [[nodiscard]] std::string getPassword() const;
 
 private:
+    int id;
     std::string username;
     std::string password;
 };
@@ -2,25 +2,23 @@
 #define USERDAO_H
 
 #include <string>
-#include "sqlite3.h"
 #include "User.h"
 
 /**
- * DAO class which handles storing and retrieving users in a 'user' table of 'db' database.
- * Takes an argument 'dbPath' which is used to open/create database and store in 'db'
- * 'user' table consists of two columns: 'username' and 'password'
+ * Interface of the storage which keeps registered users.
+ * AuthHandler and the match storages only know about this class, so the backend
+ * (SqliteUserDAO or InMemoryUserDAO) is chosen once in main.
+ * Lookups return 'default' User object (empty username) when the user does not exist.
+ * 'addUser' returns id of the new user or 0 if the username is already taken, the check and the insert are atomic.
  */
 class UserDAO {
 public:
-    explicit UserDAO(const std::string& dbPath);
-    ~UserDAO();
+    virtual ~UserDAO() = default;
 
-    [[nodiscard]] User getUserByName(const std::string& username) const;
-    void addUser(const User& user) const;
-    [[nodiscard]] bool authenticateUser(const User& user) const;
-
-private:
-    sqlite3* db{};
+    [[nodiscard]] virtual User getUserByName(const std::string& username) const = 0;
+    [[nodiscard]] virtual User getUserById(int id) const = 0;
+    virtual int addUser(const User& user) const = 0;
+    virtual void updatePassword(int id, const std::string& password) const = 0;
 };
 
 #endif // USERDAO_H
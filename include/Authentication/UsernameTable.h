@@ -0,0 +1,76 @@
+#ifndef USERNAMETABLE_H
+#define USERNAMETABLE_H
+
+#include <array>
+#include <atomic>
+#include <functional>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+/**
+ * Handle of a username interned in a UsernameTable: 'id' is unique per distinct name within the table
+ * and 'name' points to the table's only copy of it. Handles are two words, copied by value,
+ * and compared and hashed by 'id' alone. A default constructed handle is empty and names no one
+ */
+struct Username {
+    int id = 0;
+    const std::string* name = nullptr;
+
+    [[nodiscard]] bool empty() const {
+        return name == nullptr;
+    }
+    [[nodiscard]] const std::string& str() const {
+        return *name;
+    }
+    bool operator==(const Username& other) const {
+        return id == other.id;
+    }
+};
+
+template <>
+struct std::hash<Username> {
+    size_t operator()(const Username& username) const noexcept {
+        return std::hash<int>{}(username.id);
+    }
+};
+
+/**
+ * Rules for usernames and a table which keeps a single copy of every username the server works with.
+ * 'intern' returns a Username handle to that copy, which stays valid for the whole life of the table,
+ * so the same name is never stored twice however many places refer to it.
+ * 'isValid' holds the rules for new usernames, which keep every name short enough for the small string buffer
+ * of std::string. Accounts registered before the rules and bot accounts may break them, such names are interned
+ * all the same, they just do not fit the buffer.
+ *
+ * Names are spread over 'SHARDS' sets, each with its own reader-writer lock.
+ */
+class UsernameTable {
+public:
+    static constexpr size_t MIN_LENGTH = 3;
+    static constexpr size_t MAX_LENGTH = 15;
+
+    UsernameTable() = default;
+    ~UsernameTable() = default;
+
+    UsernameTable(const UsernameTable&) = delete;
+    UsernameTable& operator=(const UsernameTable&) = delete;
+
+    [[nodiscard]] static bool isValid(std::string_view username);
+    Username intern(std::string_view username);
+    [[nodiscard]] size_t size() const;
+
+private:
+    static constexpr size_t SHARDS = 16;
+
+    struct Shard {
+        mutable std::shared_mutex mutex;
+        std::unordered_map<std::string, int> names;
+    };
+
+    std::array<Shard, SHARDS> shards;
+    std::atomic<int> nextId{1};
+};
+
+#endif //USERNAMETABLE_H
@@ -0,0 +1,115 @@
+#ifndef BINARYPROTOCOL_H
+#define BINARYPROTOCOL_H
+
+#include <winsock2.h>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include "Outbox.h"
+
+/**
+ * Compact protocol for bots and load generators, offered next to the text dialogue.
+ * A client opts in by sending 'BINARY_HELLO' (NUL 'P' 'D' 'B' followed by the protocol version) right after it connects,
+ * before the first prompt of the server; a connection which sends nothing within a few milliseconds talks text.
+ * The server answers WELCOME and from then on both sides only exchange frames:
+ *
+ *     1 byte type | 2 byte payload length | payload
+ *
+ * Integers are big endian, doubles are sent as the big endian bits of IEEE 754 binary64,
+ * strings as a 1 byte length followed by the bytes. Payload of every frame type is listed next to it.
+ * Binary clients go through the same login, matchmaking and games as text clients, only the wording differs.
+ */
+enum class FrameType : uint8_t {
+    //client -> server
+    REGISTER = 1,       //string username, string password
+    LOGIN = 2,          //string username, string password
+    RESUME = 3,         //string session token
+    QUEUE = 4,          //u8 games (1-Server::MAX_GAMES_PER_CLIENT), string variant (empty for the first one)
+    MOVE = 5,           //u32 game id, u8 move (0 SPLIT, 1 STEAL)
+    LEADERBOARD = 6,    //u8 rows
+    EXIT = 7,           //nothing
+
+    //server -> client
+    WELCOME = 64,       //u8 protocol version
+    NOTICE = 65,        //string message, e.g. the result of REGISTER
+    REFUSED = 66,       //string reason a request was refused
+    LOGGED_IN = 67,     //u32 user id, string session token (empty after RESUME)
+    QUEUE_TIMEOUT = 68, //nothing, some or all of the queued games found no opponents
+    GAME_START = 69,    //u32 game id, u8 own seat, u8 players, string username of every seat
+    MOVE_REQUEST = 70,  //u32 game id, u16 round (from 1)
+    ROUND_RESULT = 71,  //u32 game id, u16 round, u8 players, u8 move and i32 coins so far of every seat
+    GAME_OVER = 72,     //u32 game id, u8 players, f64 average of every seat, u8 result (0 lost, 1 won, 2 draw)
+    STANDINGS = 73,     //u8 rows, string username and f64 average of every row, then the same of the client
+};
+
+constexpr uint8_t BINARY_PROTOCOL_VERSION = 1;
+constexpr std::array<char, 4> BINARY_HELLO = {'\0', 'P', 'D', 'B'};
+constexpr size_t FRAME_HEADER_SIZE = 3;
+//Longest payload a client may send, a bigger frame is a protocol error
+constexpr size_t MAX_FRAME_PAYLOAD = 512;
+
+std::optional<uint8_t> negotiateBinary(SOCKET clientSocket, std::chrono::milliseconds firstByteWait,
+                                       std::chrono::milliseconds helloWait);
+
+/**
+ * Builds one frame at a time in a buffer which is reused for the next frame, so after the first few frames
+ * writing one does not allocate. Strings longer than 255 bytes are cut
+ */
+class FrameWriter {
+public:
+    FrameWriter& begin(FrameType type);
+    FrameWriter& put8(uint8_t value);
+    FrameWriter& put16(uint16_t value);
+    FrameWriter& put32(uint32_t value);
+    FrameWriter& putDouble(double value);
+    FrameWriter& putString(std::string_view value);
+
+    bool sendTo(Outbox& outbox);
+
+private:
+    std::string buffer;
+};
+
+/**
+ * Reads the payload of a single frame front to back.
+ * Throws std::runtime_error when the payload is shorter than what is read from it
+ */
+class FrameReader {
+public:
+    FrameReader(FrameType type, std::string_view payload);
+
+    [[nodiscard]] FrameType getType() const;
+    uint8_t get8();
+    uint16_t get16();
+    uint32_t get32();
+    std::string getString();
+
+private:
+    std::string_view take(size_t size);
+
+    FrameType type;
+    std::string_view payload;
+};
+
+/**
+ * Cuts the byte stream of one connection into frames. 'feed' whatever recv returned, then take frames with 'next'
+ * until it gives std::nullopt; a FrameReader is only valid until the next 'feed'.
+ * 'next' throws std::runtime_error for a frame longer than 'MAX_FRAME_PAYLOAD'
+ */
+class FrameReceiver {
+public:
+    void feed(std::string_view bytes);
+    std::optional<FrameReader> next();
+
+private:
+    [[nodiscard]] std::optional<FrameType> peek() const;
+    [[nodiscard]] size_t payloadLength() const;
+
+    std::string buffer;
+    size_t start = 0;
+};
+
+#endif //BINARYPROTOCOL_H
@@ -0,0 +1,24 @@
+#ifndef BLOCKLISTCHECKER_H
+#define BLOCKLISTCHECKER_H
+
+#include "PasswordChecker.h"
+#include "BlocklistFilter.h"
+
+/**
+ * BlocklistChecker rejects passwords which appear in a list of breached or too common passwords.
+ * The list itself is never loaded, only looked up in the memory-mapped 'filter'.
+ * Rules of 'nextChecker' (length, character classes...) are cheaper and tell the user more,
+ * so they run first and the blocklist is consulted only for passwords which passed them
+ */
+class BlocklistChecker final : public PasswordChecker {
+public:
+    explicit BlocklistChecker(std::shared_ptr<BlocklistFilter> filter, std::shared_ptr<PasswordChecker> nextChecker = nullptr)
+        : PasswordChecker(std::move(nextChecker)), filter(std::move(filter)) {}
+
+    [[nodiscard]] std::string check(const std::string& password) const override;
+
+private:
+    std::shared_ptr<BlocklistFilter> filter;
+};
+
+#endif //BLOCKLISTCHECKER_H
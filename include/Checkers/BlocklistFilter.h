@@ -0,0 +1,73 @@
+#ifndef BLOCKLISTFILTER_H
+#define BLOCKLISTFILTER_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * Read-only view of a blocked Bloom filter file built by 'BuildBlocklist' (see tools/).
+ * The file is memory-mapped rather than read, so the operating system pages in only the parts
+ * which are actually touched and a blocklist of millions of passwords costs no heap memory.
+ *
+ * Every entry sets all of its bits inside one 64 byte block (one cache line), so a lookup
+ * costs a single cache miss. 'mayContain' never misses a listed password, but may report
+ * an unlisted one with the false positive rate chosen when the filter was built.
+ *
+ * Throws std::runtime_error if the file can not be mapped or is not a blocklist filter.
+ */
+class BlocklistFilter {
+public:
+    explicit BlocklistFilter(const std::string& path);
+    ~BlocklistFilter();
+
+    BlocklistFilter(const BlocklistFilter&) = delete;
+    BlocklistFilter& operator=(const BlocklistFilter&) = delete;
+
+    [[nodiscard]] bool mayContain(std::string_view password) const;
+    [[nodiscard]] uint64_t getEntryCount() const;
+
+    static constexpr size_t BLOCK_BYTES = 64;
+
+    /**
+     * File layout, the header takes a whole block so that blocks stay cache line aligned:
+     * 64 byte header followed by 'blockCount' blocks of 'BLOCK_BYTES' bytes
+     */
+    struct Header {
+        char magic[8];
+        uint64_t blockCount;
+        uint64_t entryCount;
+        uint32_t hashCount;
+        char reserved[36];
+    };
+    static constexpr char MAGIC[8] = {'P', 'D', 'B', 'L', 'O', 'O', 'M', '1'};
+
+    static uint64_t hash(std::string_view password);
+    static bool test(const uint8_t* block, uint64_t hash, uint32_t hashCount);
+    static void set(uint8_t* block, uint64_t hash, uint32_t hashCount);
+
+private:
+    void* file;
+    void* mapping;
+    const uint8_t* view;
+    Header header;
+};
+
+/**
+ * Builds a filter file for BlocklistFilter. The bit array is sized up front from 'expectedEntries',
+ * 'bitsPerEntry' trades file size for false positives (10 bits give roughly 1%)
+ */
+class BlocklistFilterBuilder {
+public:
+    BlocklistFilterBuilder(uint64_t expectedEntries, double bitsPerEntry);
+
+    void add(std::string_view password);
+    void save(const std::string& path) const;
+
+private:
+    BlocklistFilter::Header header;
+    std::vector<uint8_t> blocks;
+};
+
+#endif //BLOCKLISTFILTER_H
@@ -0,0 +1,59 @@
+#ifndef CHARCLASSSCANNER_H
+#define CHARCLASSSCANNER_H
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+/**
+ * Character classes a password can contain, as bits of the mask returned by 'scanCharClasses'.
+ * Classification is plain ASCII and does not depend on the C locale, every byte outside
+ * ASCII sets NON_ASCII, control characters and space set nothing
+ */
+enum class CharClass : uint8_t {
+    LOWER = 1,
+    UPPER = 2,
+    DIGIT = 4,
+    SYMBOL = 8,
+    NON_ASCII = 16
+};
+
+//Character class of every byte, used by the scalar scan and for the tail of the vectorized one
+constexpr std::array<uint8_t, 256> CHAR_CLASSES = [] {
+    std::array<uint8_t, 256> table{};
+    for (int c = 0; c < 256; c++) {
+        if (c >= 'a' && c <= 'z') {
+            table[c] = (uint8_t)CharClass::LOWER;
+        } else if (c >= 'A' && c <= 'Z') {
+            table[c] = (uint8_t)CharClass::UPPER;
+        } else if (c >= '0' && c <= '9') {
+            table[c] = (uint8_t)CharClass::DIGIT;
+        } else if (c > ' ' && c < 127) {
+            table[c] = (uint8_t)CharClass::SYMBOL;
+        } else if (c >= 128) {
+            table[c] = (uint8_t)CharClass::NON_ASCII;
+        }
+    }
+    return table;
+}();
+
+//Table driven scan, usable in constant expressions
+constexpr uint8_t scanCharClassesScalar(const std::string_view text) {
+    uint8_t classes = 0;
+    for (const char c : text) {
+        classes |= CHAR_CLASSES[(unsigned char)c];
+    }
+    return classes;
+}
+
+/**
+ * Returns mask of all CharClass values present in 'text', computed in a single pass.
+ * Uses SSE2 (16 bytes per step) where the target has it and falls back to 'scanCharClassesScalar'
+ */
+uint8_t scanCharClasses(std::string_view text);
+
+constexpr bool hasCharClass(const uint8_t classes, const CharClass charClass) {
+    return (classes & (uint8_t)charClass) != 0;
+}
+
+#endif //CHARCLASSSCANNER_H
@@ -0,0 +1,137 @@
+#ifndef PASSWORDPOLICY_H
+#define PASSWORDPOLICY_H
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include "PasswordChecker.h"
+#include "CharClassScanner.h"
+
+/**
+ * Password rules evaluated at compile time.
+ * A password is scanned exactly once into 'PasswordStats' (its length and which character classes
+ * it contains), then every rule of the policy looks only at those stats. Rules are plain types with
+ * a static 'check' returning an empty string_view on success or a message with static storage,
+ * so checking a password allocates nothing and involves no virtual calls:
+ *
+ *     constexpr PasswordPolicy<MinLength<8>, RequireUpperCase, RequireLowerCase> policy;
+ *     std::string_view error = policy.check(password);
+ *
+ * Rules are checked in the order they are listed and the first failing one is reported,
+ * exactly like the old LengthChecker -> UpperCaseChecker -> LowerCaseChecker chain did.
+ */
+struct PasswordStats {
+    size_t length = 0;
+    uint8_t classes = 0;
+
+    [[nodiscard]] constexpr bool has(const CharClass charClass) const {
+        return hasCharClass(classes, charClass);
+    }
+
+    //The single pass over 'password' which every rule relies on, vectorized unless evaluated at compile time
+    static constexpr PasswordStats of(const std::string_view password) {
+        if (std::is_constant_evaluated()) {
+            return {password.size(), scanCharClassesScalar(password)};
+        }
+        return {password.size(), scanCharClasses(password)};
+    }
+};
+
+//"Password must be at least N characters long." built at compile time for a given N
+template <size_t N>
+constexpr auto minLengthMessage() {
+    constexpr std::string_view prefix = "Password must be at least ";
+    constexpr std::string_view suffix = " characters long.";
+    std::array<char, 64> digits{};
+    size_t count = 0;
+    size_t value = N;
+    do {
+        digits[count++] = (char)('0' + value % 10);
+        value /= 10;
+    } while (value > 0);
+
+    std::array<char, 128> message{};
+    size_t size = 0;
+    for (const char c : prefix) message[size++] = c;
+    while (count > 0) message[size++] = digits[--count];
+    for (const char c : suffix) message[size++] = c;
+    return std::pair{message, size};
+}
+
+template <size_t N>
+struct MinLength {
+    static constexpr auto message = minLengthMessage<N>();
+
+    static constexpr std::string_view check(const PasswordStats& stats) {
+        return stats.length < N ? std::string_view(message.first.data(), message.second) : std::string_view();
+    }
+};
+
+template <CharClass Class>
+struct Require {
+    static constexpr std::string_view check(const PasswordStats& stats) {
+        if (stats.has(Class)) {
+            return {};
+        }
+        switch (Class) {
+            case CharClass::LOWER: return "Password must contain lower-case letter.";
+            case CharClass::UPPER: return "Password must contain upper-case letter.";
+            case CharClass::DIGIT: return "Password must contain digit.";
+            default: return "Password must contain symbol.";
+        }
+    }
+};
+
+using RequireLowerCase = Require<CharClass::LOWER>;
+using RequireUpperCase = Require<CharClass::UPPER>;
+using RequireDigit = Require<CharClass::DIGIT>;
+using RequireSymbol = Require<CharClass::SYMBOL>;
+
+//Character diversity: at least N different classes out of lower-case, upper-case, digit and symbol
+template <int N>
+struct MinClasses {
+    static_assert(N >= 1 && N <= 4, "there are only 4 character classes");
+
+    static constexpr auto message = [] {
+        constexpr std::string_view format = "Password must contain at least # of: "
+                                            "lower-case letter, upper-case letter, digit, symbol.";
+        std::array<char, format.size() + 1> text{};
+        for (size_t i = 0; i < format.size(); i++) {
+            text[i] = format[i] == '#' ? (char)('0' + N) : format[i];
+        }
+        return text;
+    }();
+
+    static constexpr std::string_view check(const PasswordStats& stats) {
+        return std::popcount((unsigned)(stats.classes & 15)) >= N ? std::string_view() : std::string_view(message.data());
+    }
+};
+
+template <typename... Rules>
+struct PasswordPolicy {
+    [[nodiscard]] static constexpr std::string_view check(const std::string_view password) {
+        const PasswordStats stats = PasswordStats::of(password);
+        std::string_view error;
+        ((error.empty() ? (void)(error = Rules::check(stats)) : (void)0), ...);
+        return error;
+    }
+};
+
+/**
+ * Lets a policy stand in for the old chain wherever a PasswordChecker is expected (e.g. AuthHandler).
+ * Only the final result crosses the virtual call, the rules themselves are still inlined.
+ */
+template <typename Policy>
+class PolicyChecker final : public PasswordChecker {
+public:
+    [[nodiscard]] std::string check(const std::string& password) const override {
+        return std::string(Policy::check(password));
+    }
+};
+
+#endif //PASSWORDPOLICY_H
@@ -0,0 +1,35 @@
+#ifndef RUNTIMEPASSWORDPOLICY_H
+#define RUNTIMEPASSWORDPOLICY_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include "PasswordPolicy.h"
+
+/**
+ * Same rules as PasswordPolicy, but chosen when the server starts instead of when it is compiled,
+ * for operators who keep the policy in configuration. The policy is described by a comma separated
+ * 'spec' such as "length=8,upper,lower,digit,symbol,classes=3", rules are checked in the order they are listed.
+ *
+ * The password is still scanned once into PasswordStats and all messages are built in the constructor,
+ * so 'check' allocates only for the returned std::string and only when the password is rejected.
+ */
+class RuntimePasswordPolicy final : public PasswordChecker {
+public:
+    explicit RuntimePasswordPolicy(const std::string& spec);
+
+    [[nodiscard]] std::string check(const std::string& password) const override;
+    [[nodiscard]] std::string_view verdict(std::string_view password) const;
+
+private:
+    struct Rule {
+        size_t minLength;
+        uint8_t classes;
+        int minClasses;
+        std::string message;
+    };
+
+    std::vector<Rule> rules;
+};
+
+#endif //RUNTIMEPASSWORDPOLICY_H
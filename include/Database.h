@@ -0,0 +1,80 @@
+#ifndef DATABASE_H
+#define DATABASE_H
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <chrono>
+#include <condition_variable>
+#include <unordered_map>
+#include "sqlite3.h"
+
+/**
+ * Owns every SQLite connection of the server, so all DAOs which work with the same file share them
+ * instead of opening their own.
+ * There is exactly one writer connection (SQLite allows only one writer at a time anyway) and a small pool
+ * of reader connections. The database is switched to WAL mode, so readers never wait for the writer.
+ *
+ * DAOs borrow a connection with 'writer()' or 'reader()' and keep the returned Connection only for
+ * the duration of a single operation. Prepared statements are cached per connection.
+ * SQLITE_BUSY (another process holds the file lock) is retried by SQLite's busy handler for up to 'busyTimeout'
+ * before an exception is thrown.
+ */
+class Database {
+    struct Slot {
+        sqlite3* db{};
+        std::unordered_map<std::string, sqlite3_stmt*> statements;
+    };
+
+public:
+    /**
+     * Connection borrowed from Database. Gives it back once destroyed.
+     * Statements returned by 'prepare' belong to the connection and must not be finalized by the caller
+     */
+    class Connection {
+    public:
+        Connection(Connection&& other) noexcept;
+        Connection(const Connection&) = delete;
+        Connection& operator=(const Connection&) = delete;
+        ~Connection();
+
+        [[nodiscard]] sqlite3* get() const;
+        sqlite3_stmt* prepare(const std::string& sql);
+        int step(sqlite3_stmt* stmt) const;
+        void exec(const std::string& sql, const std::string& context) const;
+        void execTransaction(const std::string& sql, const std::string& context) const;
+        [[nodiscard]] bool hasColumn(const std::string& table, const std::string& column);
+
+    private:
+        friend class Database;
+        Connection(Database* database, Slot* slot, bool isWriter);
+
+        Database* database;
+        Slot* slot;
+        bool isWriter;
+        std::vector<sqlite3_stmt*> used;
+    };
+
+    explicit Database(const std::string& dbPath, int readers = 4,
+                      std::chrono::milliseconds busyTimeout = std::chrono::milliseconds(5000));
+    ~Database();
+
+    Connection writer();
+    Connection reader();
+
+private:
+    sqlite3* open(const std::string& dbPath) const;
+    void release(Slot* slot, bool isWriter);
+
+    std::chrono::milliseconds busyTimeout;
+
+    std::mutex writerMutex;
+    Slot writerSlot;
+
+    std::mutex readersMutex;
+    std::condition_variable cvReaders;
+    std::vector<Slot> readerSlots;
+    std::vector<Slot*> freeReaders;
+};
+
+#endif //DATABASE_H
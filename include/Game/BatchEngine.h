@@ -0,0 +1,67 @@
+#ifndef BATCHENGINE_H
+#define BATCHENGINE_H
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+#include "Payoff.h"
+
+/**
+ * Memory-one strategy compiled to a lookup table: probability of stealing in the first round and
+ * after each of the four possible previous rounds, indexed by (my last move, opponent's last move)
+ * as CC, CD, DC, DD where C is SPLIT and D is STEAL. Probabilities are in 1/65536 units,
+ * 'ALWAYS' (65536) means certainly steal and 0 means certainly split.
+ */
+struct MemoryOneStrategy {
+    static constexpr uint32_t ALWAYS = 1 << 16;
+
+    std::string name;
+    uint32_t first;
+    std::array<uint32_t, 4> afterRound;
+
+    static MemoryOneStrategy deterministic(std::string name, Move first, Move afterCC, Move afterCD,
+                                           Move afterDC, Move afterDD);
+};
+
+//The built-in strategies of the game kernel (see Strategy.h) expressed as memory-one tables
+std::vector<MemoryOneStrategy> builtinMemoryOneStrategies();
+
+/**
+ * Coins collected by both sides over all matches of a batch
+ */
+struct BatchScore {
+    long long score1 = 0;
+    long long score2 = 0;
+    int matches = 0;
+};
+
+/**
+ * Plays many matches at once using the fact that a move is a single bit.
+ * Moves of 'LANES' independent matches in one round are kept as 'WORDS' 64-bit masks (bit set = STEAL),
+ * the next moves are computed from the lookup table with a handful of bitwise operations per word, and
+ * the payoff of a round is read from four popcounts (how many lanes ended CC, CD, DC and DD) weighted by
+ * the same payoff table GameSession uses. Words are plain arrays processed in straight loops, so for
+ * deterministic tables the compiler turns a round into a few SIMD instructions.
+ *
+ * Randomness (stochastic strategies and 'noise', the probability that a move is flipped by mistake)
+ * is bitsliced: 16 random words are compared lane-wise against the probability at once.
+ */
+class BatchEngine {
+public:
+    static constexpr int WORDS = 4;
+    static constexpr int LANES = WORDS * 64;
+
+    BatchEngine(int rounds, double noise = 0.0);
+    ~BatchEngine() = default;
+
+    [[nodiscard]] BatchScore playBatch(const MemoryOneStrategy& first, const MemoryOneStrategy& second,
+                                       uint64_t seed) const;
+
+private:
+    int rounds;
+    uint32_t noise;
+};
+
+#endif //BATCHENGINE_H
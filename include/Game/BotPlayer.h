@@ -0,0 +1,17 @@
+#ifndef BOTPLAYER_H
+#define BOTPLAYER_H
+
+#include <memory>
+#include "Strategy.h"
+#include "UsernameTable.h"
+
+/**
+ * Server-side opponent: the account its matches are stored under and the strategy every game plays a fresh copy of
+ */
+struct BotPlayer {
+    Username username;
+    int userId;
+    std::shared_ptr<Strategy> strategy;
+};
+
+#endif //BOTPLAYER_H
@@ -0,0 +1,58 @@
+#ifndef BRACKET_H
+#define BRACKET_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+/**
+ * Pairings and standings of a tournament played by clients, entrants are numbered 0 to 'players' - 1.
+ * ROUND_ROBIN: everybody meets everybody once (circle method, 'players' - 1 rounds, one more for an odd count).
+ * SWISS: every round pairs entrants with the same or the closest standing who did not meet yet, so a winner
+ * emerges after about log2(players) rounds even in brackets of thousands.
+ *
+ * A win is worth 1 point and a draw 1/2, coins collected break ties. With an odd number of entrants one of them
+ * sits out each round with a bye, which counts as a win (in Swiss the lowest ranked entrant who has not had one yet).
+ * Bracket holds no lock, the owner has to serialize calls.
+ */
+class Bracket {
+public:
+    enum class Format { ROUND_ROBIN, SWISS };
+    static constexpr int BYE = -1;
+
+    struct Standing {
+        int player;
+        double points = 0;
+        long long coins = 0;
+        int games = 0;
+    };
+
+    Bracket(Format format, int players, int rounds = 0);
+    ~Bracket() = default;
+
+    static Format parseFormat(const std::string& name);
+
+    std::vector<std::pair<int, int>> nextRound();
+    void report(int first, int second, int coins1, int coins2);
+
+    [[nodiscard]] std::vector<Standing> getStandings() const;
+    [[nodiscard]] int getRound() const;
+    [[nodiscard]] int getRounds() const;
+
+private:
+    [[nodiscard]] static uint64_t key(int first, int second);
+    [[nodiscard]] std::vector<std::pair<int, int>> roundRobinRound() const;
+    [[nodiscard]] std::vector<std::pair<int, int>> swissRound();
+
+    Format format;
+    int players;
+    int rounds;
+    int round = 0;
+    std::vector<Standing> standings;
+    std::vector<bool> hadBye;
+    std::unordered_set<uint64_t> played;
+};
+
+#endif //BRACKET_H
@@ -0,0 +1,52 @@
+#ifndef BROADCAST_H
+#define BROADCAST_H
+
+#include <winsock2.h>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+/**
+ * Live feed of one game for its spectators.
+ * The game serializes every round result once into a shared, reference counted buffer and 'publish' hands
+ * that same buffer to every subscriber, then writes to each of them without blocking. Whatever a socket does not
+ * take at once stays pending and is written later by 'flush' (called by the spectator's own thread), so a slow
+ * spectator never slows the game down.
+ *
+ * A spectator falling behind does not pile up buffers: round results carry the whole standings, so older unsent
+ * results are dropped and only the newest 'MAX_PENDING' are kept (a result which is half written is always finished).
+ */
+class Broadcast {
+public:
+    static constexpr size_t MAX_PENDING = 2;
+
+    explicit Broadcast(std::string title);
+    ~Broadcast() = default;
+
+    bool subscribe(SOCKET socket);
+    void unsubscribe(SOCKET socket);
+    void publish(const std::string& message);
+    bool flush(SOCKET socket);
+    void close();
+
+    [[nodiscard]] const std::string& getTitle() const;
+    [[nodiscard]] bool isClosed() const;
+    [[nodiscard]] size_t getSpectators() const;
+
+private:
+    struct Subscriber {
+        std::deque<std::shared_ptr<const std::string>> pending;
+        size_t offset = 0;
+    };
+    static void write(SOCKET socket, Subscriber& subscriber);
+
+    const std::string title;
+    mutable std::mutex mutex;
+    std::unordered_map<SOCKET, Subscriber> subscribers;
+    std::shared_ptr<const std::string> latest;
+    bool closed = false;
+};
+
+#endif //BROADCAST_H
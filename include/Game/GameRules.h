@@ -0,0 +1,67 @@
+#ifndef GAMERULES_H
+#define GAMERULES_H
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <utility>
+#include "Payoff.h"
+#include "Random.h"
+
+/**
+ * Variant of the game a match is played with: the payoff matrix, how many rounds a match lasts
+ * and 'noise', the probability that a move is flipped before it counts (a trembling hand).
+ * The default constructed rules are the classic game: 3/0/5/1 payoffs, 3 to 5 rounds, no noise.
+ *
+ * Rules are loaded at startup from a spec (see '--variant' in main) such as
+ *     "noisy:payoff=3/0/5/1,rounds=5-10,noise=0.05"
+ * where 'payoff' lists the coins of a player for SPLIT/SPLIT, SPLIT/STEAL, STEAL/SPLIT and STEAL/STEAL,
+ * 'rounds' is either an inclusive range "min-max" picked uniformly or "~mean" for a geometric number of rounds
+ * (after every round the match goes on with probability 1 - 1/mean), capped at 'MAX_ROUNDS'.
+ * Every key is optional, missing keys keep their classic value.
+ *
+ * 'players=N' seats N players at a table. By default a player then gets the sum of the payoffs against every
+ * other player. 'goods=r' turns the table into a public goods game instead: each round every player receives
+ * N coins, those who SPLIT put theirs into a pot which is multiplied by r and shared equally, so a player gets
+ * r * (splitting players) when splitting and N + r * (splitting others) when stealing (1 < r < N).
+ * Either way coins depend only on the own move and on how many others split, which is the table 'coins' reads.
+ *
+ * All randomness of a game comes from one Xoshiro256 seeded with the seed of the game (see GameSession),
+ * the number of rounds is always drawn first, so 'replay' can check a stored match against its seed.
+ */
+class GameRules {
+public:
+    static constexpr int MAX_ROUNDS = 100;
+    static constexpr int MAX_PLAYERS = 16;
+    //Names are stored with every match (see JournalMatchDAO), so they are kept short
+    static constexpr int MAX_NAME_LENGTH = 16;
+
+    GameRules();
+
+    static GameRules parse(const std::string& spec);
+
+    [[nodiscard]] const std::string& getName() const;
+    [[nodiscard]] int getPlayers() const;
+    [[nodiscard]] int coins(Move move, int splittingOthers) const;
+    [[nodiscard]] int drawRounds(Xoshiro256& generator) const;
+    [[nodiscard]] Move applyNoise(Move move, Xoshiro256& generator) const;
+    [[nodiscard]] std::pair<int, int> replay(uint64_t seed, const MoveLog& moves) const;
+
+private:
+    void buildTable();
+
+    std::string name = "classic";
+    //Coins of one player for SPLIT/SPLIT, SPLIT/STEAL, STEAL/SPLIT and STEAL/STEAL
+    std::array<int, 4> matrix = {PAYOFFS[0][0].first, PAYOFFS[0][1].first, PAYOFFS[1][0].first, PAYOFFS[1][1].first};
+    int players = 2;
+    int goods = 0;
+    //Coins indexed by own move and number of other players who split
+    std::array<std::vector<int>, 2> table;
+    int minRounds = 3;
+    int maxRounds = 5;
+    double meanRounds = 0;
+    double noise = 0;
+};
+
+#endif //GAMERULES_H
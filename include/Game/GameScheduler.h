@@ -0,0 +1,60 @@
+#ifndef GAMESCHEDULER_H
+#define GAMESCHEDULER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "GameSession.h"
+
+/**
+ * Runs any number of games on a fixed pool of threads.
+ * A GameSession is a state machine: 'step' does whatever the game can do right now (send prompts, take moves
+ * which already arrived, score a round) and tells when it wants to run again. Games waiting for moves or for
+ * the pause between rounds cost no thread at all, they are stepped again once their time comes or 'wake'
+ * is called because a move arrived. A game is never stepped by two threads at once.
+ */
+class GameScheduler {
+public:
+    explicit GameScheduler(int threads);
+    ~GameScheduler();
+
+    GameScheduler(const GameScheduler&) = delete;
+    GameScheduler& operator=(const GameScheduler&) = delete;
+
+    void add(int gameId, std::unique_ptr<GameSession> session);
+    void wake(int gameId);
+    void stop();
+
+    [[nodiscard]] size_t getGames() const;
+
+private:
+    using Clock = GameSession::Clock;
+
+    struct Game {
+        std::unique_ptr<GameSession> session;
+        Clock::time_point wakeAt;
+        bool queued = false;
+        bool running = false;
+        bool woken = false;
+    };
+
+    void work();
+
+    mutable std::mutex mutex;
+    std::condition_variable cvWork;
+    std::unordered_map<int, Game> games;
+    std::deque<int> ready;
+    std::priority_queue<std::pair<Clock::time_point, int>, std::vector<std::pair<Clock::time_point, int>>,
+                        std::greater<>> timers;
+    bool stopping = false;
+    std::vector<std::thread> workers;
+};
+
+#endif //GAMESCHEDULER_H
@@ -3,38 +3,116 @@
 
 #include <string>
 #include <winsock2.h>
+#include <chrono>
+#include <functional>
+#include <optional>
+#include <memory>
 #include <mutex>
 #include <condition_variable>
-#include <unordered_set>
+#include <vector>
+#include "BinaryProtocol.h"
+#include "Broadcast.h"
+#include "GameRules.h"
 #include "MatchDao.h"
+#include "MessageWriter.h"
+#include "MoveInbox.h"
+#include "Outbox.h"
+#include "Random.h"
+#include "Strategy.h"
+#include "UsernameTable.h"
 
+/**
+ * One seat of a game: either a connected client ('outbox' its messages go through and 'inbox' its moves arrive in)
+ * or a server-side bot ('bot'). A bot is just a Strategy asked for its move, it has no thread of its own.
+ * A 'binary' client gets frames of the binary protocol (see BinaryProtocol.h) instead of text.
+ */
+struct Participant {
+    Username username;
+    int userId;
+    std::shared_ptr<Outbox> outbox;
+    std::shared_ptr<Strategy> bot;
+    std::shared_ptr<MoveInbox> inbox;
+    bool binary = false;
+};
+
+/**
+ * A game between any number of players, written as a state machine which a GameScheduler thread advances with 'step'
+ * (get ready -> prompt -> collect moves -> show result -> ... -> final scores). Moves of clients are taken from their
+ * inboxes (filled by the threads reading their connections) and messages are posted to their outboxes, so the session
+ * never blocks on a socket and never needs a thread of its own. Every round pays each player by the table of 'rules'
+ * (see GameRules).
+ *
+ * Matches are stored pairwise since MatchDAO keeps two players per match: seats 1 and 2, 3 and 4, ... each become
+ * one match with the moves of those two and their own averages. With an odd number of players the last seat
+ * is paired with the first one.
+ *
+ * Spectators follow the game through 'broadcast', which gets every round result and the final scores.
+ *
+ * Every seat has a MessageWriter kept for the whole game: messages reference the constant prompts and interned
+ * usernames, only the numbers are formatted, and each message goes out in one gather send.
+ * Binary clients get MOVE_REQUEST, ROUND_RESULT and GAME_OVER frames instead. A table without any text client
+ * skips the pauses which give people time to read, so automated clients play as fast as they answer.
+ *
+ * Everything random in a game (number of rounds, noise, bots) comes from 'seed', which is stored with its matches:
+ * the same seed and the same moves of the clients play the game out the same way again.
+ */
 class GameSession {
 public:
-    GameSession(std::string player1, SOCKET client1Socket, std::string player2, SOCKET client2Socket,
-                std::mutex& playingMutex, std::condition_variable& cvPlaying,
-                std::unordered_set<std::string>& playingUsers, std::mutex& matchDaoMutex,
-                std::shared_ptr<MatchDAO> matchDAO);
+    using Clock = std::chrono::steady_clock;
+
+    GameSession(int gameId, std::vector<Participant> players,
+                std::mutex& playingMutex, std::condition_variable& cvPlaying, std::shared_ptr<MatchDAO> matchDAO,
+                std::shared_ptr<const GameRules> rules = std::make_shared<const GameRules>(),
+                std::shared_ptr<Broadcast> broadcast = nullptr, uint64_t seed = 0);
     ~GameSession() = default;
 
-    void runGame();
+    std::optional<Clock::time_point> step();
+    void setOnFinished(std::function<void(const std::vector<int>& scores)> callback);
+    static void send(const Participant& participant, int gameId, const std::string& message);
 
 private:
-    void updateScores(const std::string& player1Str, const std::string& player2Str);
-    void playRound();
+    enum class State { STARTING, PROMPTING, COLLECTING, SHOWING, FINISHING };
+
+    void start();
+    void prompt();
+    bool collectMoves();
+    void scoreRound();
+    void finish();
+    void release();
+    void saveMatches(int rounds) const;
+    std::optional<Move> readMove(size_t seat, Move opponentLast) const;
+    MessageWriter& message(size_t seat);
+    void send(size_t seat);
+    void addScores(MessageWriter& writer) const;
+    void sendFrame(size_t seat);
+    [[nodiscard]] Clock::time_point after(std::chrono::seconds pause) const;
 
-    std::string player1;
-    SOCKET client1Socket;
-    std::string player2;
-    SOCKET client2Socket;
+    int gameId;
+    //"#<gameId> ", put in front of every line sent to a client playing several games
+    std::string tag;
+    State state = State::STARTING;
+    Clock::time_point resumeAt;
+    int roundNumber = 0;
+    std::vector<std::optional<Move>> roundMoves;
+    std::function<void(const std::vector<int>&)> onFinished;
 
-    int score1;
-    int score2;
+    std::vector<Participant> players;
+    std::vector<int> scores;
+    //Moves of every seat in every round, history[seat][round]
+    std::vector<std::vector<Move>> history;
+    std::vector<MessageWriter> writers;
+    MessageWriter feed;
+    FrameWriter frame;
+    //Whether a text client sits at the table, only then the game pauses between its steps
+    bool paced = false;
+    std::shared_ptr<const GameRules> rules;
+    uint64_t seed;
+    Xoshiro256 generator;
+    std::shared_ptr<Broadcast> broadcast;
 
     std::mutex& playingMutex;
     std::condition_variable& cvPlaying;
-    std::unordered_set<std::string>& playingUsers;
 
-    std::mutex& matchDaoMutex;
     std::shared_ptr<MatchDAO> matchDAO;
 };
 
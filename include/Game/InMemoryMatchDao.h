@@ -0,0 +1,51 @@
+#ifndef INMEMORYMATCHDAO_H
+#define INMEMORYMATCHDAO_H
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include "MatchDao.h"
+#include "UserDao.h"
+
+/**
+ * MatchDAO which keeps matches only in memory, used to measure the server without any disk I/O.
+ * Score totals are sharded by user id and matches (for their move logs, seeds and variants) by match id,
+ * every shard has its own mutex, so games finishing at the same time rarely wait for each other.
+ * Usernames for leaderboard rows are taken from 'userDao'.
+ */
+class InMemoryMatchDAO final : public MatchDAO {
+public:
+    explicit InMemoryMatchDAO(std::shared_ptr<UserDAO> userDao);
+    ~InMemoryMatchDAO() override = default;
+
+    int addMatch(const Match& match) const override;
+    [[nodiscard]] MoveLog getMoveLog(int matchId) const override;
+    [[nodiscard]] uint64_t getSeed(int matchId) const override;
+    [[nodiscard]] std::pair<std::string, int> getVariant(int matchId) const override;
+    [[nodiscard]] std::pair<double, double> getScores(int matchId) const override;
+    [[nodiscard]] std::pair<std::string, double> getAverageScore(int userId) const override;
+    [[nodiscard]] std::vector<std::pair<std::string, double>> getTopPlayers(int num) const override;
+
+private:
+    static constexpr size_t SHARDS = 16;
+
+    struct TotalsShard {
+        std::mutex mutex;
+        std::unordered_map<int, std::pair<double, int>> totals;
+    };
+    struct MatchesShard {
+        std::mutex mutex;
+        std::unordered_map<int, Match> matches;
+    };
+
+    void addScore(int userId, double score) const;
+
+    std::shared_ptr<UserDAO> userDao;
+    mutable std::array<TotalsShard, SHARDS> totalsShards;
+    mutable std::array<MatchesShard, SHARDS> matchesShards;
+    mutable std::atomic<int> nextId{1};
+};
+
+#endif //INMEMORYMATCHDAO_H
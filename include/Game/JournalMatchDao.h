@@ -0,0 +1,76 @@
+#ifndef JOURNALMATCHDAO_H
+#define JOURNALMATCHDAO_H
+
+#include <cstdio>
+#include <string>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <chrono>
+#include <condition_variable>
+#include <unordered_map>
+#include <vector>
+#include "MatchDao.h"
+#include "SqliteMatchDao.h"
+#include "UserDao.h"
+
+/**
+ * MatchDAO backend for servers where SQLite inserts are the bottleneck.
+ * Every match is appended to 'journalPath' as a fixed-size, checksummed record, the file is flushed
+ * after every append and synced to disk by a background thread every 'syncInterval'.
+ *
+ * Leaderboard queries are answered from in-memory totals which are rebuilt at startup from 'archive'
+ * (matches already stored in SQLite) plus a scan of the journal. A torn record at the end of the journal
+ * (crash in the middle of an append) is cut off during that scan.
+ * 'exportToArchive()' moves all journaled matches into 'archive' and empties the journal.
+ *
+ * The journal starts with a header holding 'idBase', the highest id in 'archive' when the journal was last emptied.
+ * The match with id n is the record at position n - 'idBase' and keeps id n when it is exported, so ids keep counting
+ * across exports and are never handed out twice. 'archive' should only get matches through the journal.
+ */
+class JournalMatchDAO final : public MatchDAO {
+public:
+    JournalMatchDAO(const std::string& journalPath, std::shared_ptr<UserDAO> userDao,
+                    std::shared_ptr<SqliteMatchDAO> archive,
+                    std::chrono::milliseconds syncInterval = std::chrono::milliseconds(200));
+    ~JournalMatchDAO() override;
+
+    int addMatch(const Match& match) const override;
+    [[nodiscard]] MoveLog getMoveLog(int matchId) const override;
+    [[nodiscard]] uint64_t getSeed(int matchId) const override;
+    [[nodiscard]] std::pair<std::string, int> getVariant(int matchId) const override;
+    [[nodiscard]] std::pair<double, double> getScores(int matchId) const override;
+    [[nodiscard]] std::pair<std::string, double> getAverageScore(int userId) const override;
+    [[nodiscard]] std::vector<std::pair<std::string, double>> getTopPlayers(int num) const override;
+
+    int exportToArchive();
+
+private:
+    void openJournal();
+    void rewriteJournal(const std::vector<Match>& matches, int newIdBase);
+    void scanJournal();
+    void startSync();
+    void stopSync();
+    void syncLoop();
+    void addToTotals(const Match& match) const;
+    [[nodiscard]] std::optional<Match> readMatch(int matchId) const;
+
+    std::string journalPath;
+    std::shared_ptr<UserDAO> userDao;
+    std::shared_ptr<SqliteMatchDAO> archive;
+
+    mutable std::mutex journalMutex;
+    std::FILE* journal{};
+    int idBase{};
+    mutable int records{};
+    mutable bool unsynced{};
+    mutable std::unordered_map<int, std::pair<double, int>> totals;
+
+    std::chrono::milliseconds syncInterval;
+    bool stopping{};
+    std::condition_variable cvSync;
+    std::thread syncThread;
+};
+
+#endif //JOURNALMATCHDAO_H
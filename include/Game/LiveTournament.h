@@ -0,0 +1,34 @@
+#ifndef LIVETOURNAMENT_H
+#define LIVETOURNAMENT_H
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "Bracket.h"
+#include "GameSession.h"
+
+/**
+ * How tournaments are formed: bracket format, how many entrants start one and how long the first of them waits at most
+ */
+struct TournamentSettings {
+    Bracket::Format format = Bracket::Format::SWISS;
+    int players = 8;
+    std::chrono::milliseconds wait = std::chrono::seconds(60);
+};
+
+/**
+ * Tournament being formed or played. Entrant i of 'bracket' is 'entrants[i]', a client who disconnected keeps
+ * its seat with a closed outbox and loses its remaining games by always splitting
+ */
+struct LiveTournament {
+    int id;
+    std::chrono::steady_clock::time_point formedAt;
+    std::vector<Participant> entrants;
+    std::unique_ptr<Bracket> bracket;
+    int gamesLeft = 0;
+    bool over = false;
+    std::mutex mutex;
+};
+
+#endif //LIVETOURNAMENT_H
@@ -1,28 +1,41 @@
 #ifndef MATCH_H
 #define MATCH_H
 
+#include <cstdint>
 #include <string>
+#include "MoveLog.h"
 
 /**
- * Simplest class of this project. It is here to store two usernames and
- * their corresponding average scores during the match.
+ * Simplest class of this project. It is here to store ids of two users,
+ * their corresponding average scores during the match, the moves they made in every round,
+ * the seed of the game it was played in (0 for matches stored before seeds were kept)
+ * and the variant and number of players of that game ("" and 0 for matches stored before those were kept).
  * It is used by MatchDao and GameSession to make the code more readable
  */
 class Match {
 public:
-    Match(std::string user1, double score1, std::string user2, double score2);
+    Match(int user1Id, double score1, int user2Id, double score2, MoveLog moves = {}, uint64_t seed = 0,
+          std::string variant = {}, int players = 0);
     ~Match() = default;
 
-    [[nodiscard]] std::string getUser1() const;
+    [[nodiscard]] int getUser1Id() const;
     [[nodiscard]] double getScore1() const;
-    [[nodiscard]] std::string getUser2() const;
+    [[nodiscard]] int getUser2Id() const;
     [[nodiscard]] double getScore2() const;
+    [[nodiscard]] const MoveLog& getMoves() const;
+    [[nodiscard]] uint64_t getSeed() const;
+    [[nodiscard]] const std::string& getVariant() const;
+    [[nodiscard]] int getPlayers() const;
 
 private:
-    std::string user1;
+    int user1Id;
     double score1;
-    std::string user2;
+    int user2Id;
     double score2;
+    MoveLog moves;
+    uint64_t seed;
+    std::string variant;
+    int players;
 };
 
 #endif //MATCH_H
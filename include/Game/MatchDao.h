@@ -1,27 +1,28 @@
 #ifndef MATCHDAO_H
 #define MATCHDAO_H
 
+#include <cstdint>
 #include <string>
+#include <utility>
 #include <vector>
-#include "sqlite3.h"
 #include "Match.h"
 
 /**
- * DAO class which handles storing and retrieving matches between users in a 'matches' table of 'db' database.
- * Takes an argument 'dbPath' which is used to open/create database and store in 'db'
- * 'matches' table consists of four columns: 'user1', 'score1', 'user2' and 'score2'
+ * Interface of the storage which keeps played matches and answers leaderboard queries.
+ * Server and GameSession only know about this class, so the backend (SqliteMatchDAO or JournalMatchDAO)
+ * is chosen once in main.
  */
 class MatchDAO {
 public:
-    explicit MatchDAO(const std::string& dbPath);
-    ~MatchDAO();
+    virtual ~MatchDAO() = default;
 
-    void addMatch(const Match& match) const;
-    [[nodiscard]] std::pair<std::string, double> getAverageScore(const std::string& username) const;
-    [[nodiscard]] std::vector<std::pair<std::string, double>> getTopPlayers(int num) const;
-
-private:
-    sqlite3* db{};
+    virtual int addMatch(const Match& match) const = 0;
+    [[nodiscard]] virtual MoveLog getMoveLog(int matchId) const = 0;
+    [[nodiscard]] virtual uint64_t getSeed(int matchId) const = 0;
+    [[nodiscard]] virtual std::pair<std::string, int> getVariant(int matchId) const = 0;
+    [[nodiscard]] virtual std::pair<double, double> getScores(int matchId) const = 0;
+    [[nodiscard]] virtual std::pair<std::string, double> getAverageScore(int userId) const = 0;
+    [[nodiscard]] virtual std::vector<std::pair<std::string, double>> getTopPlayers(int num) const = 0;
 };
 
 #endif //MATCHDAO_H
@@ -0,0 +1,58 @@
+#ifndef MESSAGEWRITER_H
+#define MESSAGEWRITER_H
+
+#include <winsock2.h>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Outbox.h"
+
+/**
+ * Message to one client assembled from pieces and written with a single gather send (WSASend),
+ * so the pieces are never concatenated into one string first.
+ * Constant text (prompts, labels, interned usernames) is referenced where it lives and must outlive 'sendTo',
+ * numbers are formatted with std::to_chars into a buffer owned by the writer. A writer is meant to be kept
+ * and reused for every message to the same client, after the first few messages it stops allocating.
+ *
+ * A writer started with a non-empty 'tag' (see MoveInbox, a client playing several games) puts the tag in
+ * front of every line and newline terminates the message, without copying the text it references.
+ */
+class MessageWriter {
+public:
+    //Constant messages and labels shared by every game
+    static constexpr std::string_view PROMPT = "Do you want to split or steal? (SPLIT/STEAL): ";
+    static constexpr std::string_view STEAL = "STEAL";
+    static constexpr std::string_view SPLIT = "SPLIT";
+
+    MessageWriter() = default;
+    ~MessageWriter() = default;
+
+    void begin(std::string_view tag = {});
+    MessageWriter& add(std::string_view text);
+    MessageWriter& add(int value);
+    MessageWriter& add(double value);
+
+    bool sendTo(Outbox& outbox);
+    [[nodiscard]] std::string str();
+
+private:
+    //Either text referenced where it lives ('data') or, with 'data' nullptr, 'size' bytes at 'offset' of 'buffer'
+    struct Piece {
+        const char* data;
+        size_t offset;
+        size_t size;
+    };
+
+    void push(const char* data, size_t offset, size_t size);
+    void addFormatted(const char* text, size_t size);
+    void finish();
+
+    std::string_view tag;
+    bool lineStart = true;
+    std::vector<Piece> pieces;
+    std::string buffer;
+    std::vector<WSABUF> gather;
+};
+
+#endif //MESSAGEWRITER_H
@@ -0,0 +1,50 @@
+#ifndef MOVEINBOX_H
+#define MOVEINBOX_H
+
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+#include "MoveLog.h"
+
+/**
+ * Moves of one client on their way from the thread reading its connection to the games the client plays in.
+ * Game sessions never read sockets themselves, so they can be run by a few scheduler threads (see GameScheduler)
+ * and one connection can play several games at once. Instead of waiting, a game polls the inbox and is woken up
+ * by the listener it registered with 'open' when a move arrives.
+ *
+ * A 'tagged' inbox belongs to a client playing several games at once (see Server): every message of a game
+ * is prefixed with "#<game id> " and answers are expected in the same form. Untagged moves go to whichever game asks.
+ * Moves for games the client is not playing are dropped and at most 'MAX_PENDING' unanswered moves are kept per game,
+ * so whatever a client sends it can not grow the inbox.
+ */
+class MoveInbox {
+public:
+    static constexpr int ANY_GAME = 0;
+    static constexpr size_t MAX_PENDING = 8;
+
+    explicit MoveInbox(bool tagged = false);
+    ~MoveInbox() = default;
+
+    void open(int gameId, std::function<void()> onMove);
+    void release(int gameId);
+    void deliver(int gameId, Move move);
+    std::optional<Move> poll(int gameId);
+    void close();
+
+    [[nodiscard]] bool isTagged() const;
+    [[nodiscard]] bool isPlaying() const;
+
+private:
+    std::vector<std::function<void()>> listenersOf(int gameId) const;
+
+    bool tagged;
+    bool closed = false;
+    mutable std::mutex mutex;
+    std::unordered_map<int, std::deque<Move>> moves;
+    std::unordered_map<int, std::function<void()>> listeners;
+};
+
+#endif //MOVEINBOX_H
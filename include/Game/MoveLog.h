@@ -0,0 +1,38 @@
+#ifndef MOVELOG_H
+#define MOVELOG_H
+
+#include <vector>
+#include <utility>
+
+/**
+ * Decision of a single player in a single round. Values are chosen so that a move fits in one bit
+ */
+enum class Move : unsigned char {
+    SPLIT = 0,
+    STEAL = 1
+};
+
+/**
+ * Compact record of every round of a match.
+ * Each round takes two bits (bit of player1, then bit of player2), four rounds are packed in a single byte,
+ * so a whole match is stored in a few bytes. 'bytes' is exactly what MatchDao stores in 'moves' column
+ * and the constructor taking 'bytes' and 'rounds' decodes it back for analytics or replays.
+ */
+class MoveLog {
+public:
+    MoveLog() = default;
+    MoveLog(std::vector<unsigned char> bytes, int rounds);
+    ~MoveLog() = default;
+
+    void record(Move move1, Move move2);
+
+    [[nodiscard]] int getRounds() const;
+    [[nodiscard]] std::pair<Move, Move> getRound(int round) const;
+    [[nodiscard]] const std::vector<unsigned char>& getBytes() const;
+
+private:
+    std::vector<unsigned char> bytes;
+    int rounds = 0;
+};
+
+#endif //MOVELOG_H
@@ -0,0 +1,44 @@
+#ifndef OUTBOX_H
+#define OUTBOX_H
+
+#include <winsock2.h>
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+/**
+ * Messages on their way from the games a client plays in to its connection, the counterpart of MoveInbox.
+ * Games are stepped by the few GameScheduler threads and must never wait for a client, so while the connection is
+ * 'attach'ed its socket is non-blocking: 'post' writes whatever the socket takes at once and keeps the rest pending,
+ * the thread serving the connection finishes it with 'flush' whenever the socket is writable again.
+ * Messages are queued and written whole under one lock, so several games of one client never interleave.
+ * A detached outbox writes at once like a plain send, only the connection's own thread posts to it then.
+ *
+ * A client which lets more than 'MAX_PENDING' bytes pile up does not read; its connection is shut down,
+ * which the connection's thread notices like a disconnect. A closed outbox drops every message.
+ */
+class Outbox {
+public:
+    static constexpr size_t MAX_PENDING = 64 * 1024;
+
+    explicit Outbox(SOCKET socket);
+    ~Outbox() = default;
+
+    void attach();
+    void detach();
+    bool post(std::string_view message);
+    bool post(const WSABUF* pieces, size_t count);
+    bool flush();
+    void close();
+
+private:
+    void write();
+
+    const SOCKET socket;
+    std::mutex mutex;
+    std::string pending;
+    bool closed = false;
+};
+
+#endif //OUTBOX_H
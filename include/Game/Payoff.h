@@ -0,0 +1,27 @@
+#ifndef PAYOFF_H
+#define PAYOFF_H
+
+#include <array>
+#include "MoveLog.h"
+
+/**
+ * Coins both players get for a single round, the one set of rules shared by GameSession
+ * (matches between clients) and the headless game kernel (see Strategy.h and Tournament.h):
+ * both split - 3 each, both steal - 1 each, the one who steals from a splitter takes 5 and leaves 0.
+ */
+struct Payoff {
+    int first;
+    int second;
+};
+
+//Indexed by [move of the first player][move of the second player]
+constexpr std::array<std::array<Payoff, 2>, 2> PAYOFFS = {{
+    {{{3, 3}, {0, 5}}},
+    {{{5, 0}, {1, 1}}}
+}};
+
+constexpr Payoff payoff(const Move first, const Move second) {
+    return PAYOFFS[(int)first][(int)second];
+}
+
+#endif //PAYOFF_H
@@ -0,0 +1,91 @@
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <cstdint>
+#include <limits>
+
+//SplitMix64 step: advances 'state' and returns a well mixed 64-bit value, used to expand seeds
+constexpr uint64_t splitMix64(uint64_t& state) {
+    uint64_t value = state += 0x9e3779b97f4a7c15ULL;
+    value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+    return value ^ (value >> 31);
+}
+
+/**
+ * Seed of the 'index'-th independent stream of 'seed'. Streams are picked by position instead of being drawn
+ * from a shared generator, so any thread can derive any stream without locking and the result does not depend
+ * on which thread asked first
+ */
+constexpr uint64_t streamSeed(const uint64_t seed, const uint64_t index) {
+    uint64_t state = seed + index * 0x9e3779b97f4a7c15ULL;
+    return splitMix64(state);
+}
+
+/**
+ * xoshiro256** generator: 32 bytes of state, a handful of instructions per number and a cheap 'seed',
+ * where std::mt19937 keeps 2.5 KB of state and reseeding it costs hundreds of steps.
+ * Satisfies UniformRandomBitGenerator, so it works with the <random> distributions.
+ * The same seed always gives the same sequence, which is what makes games replayable. The algorithms of
+ * the <random> distributions differ between standard libraries though, so whatever a replay has to draw again
+ * is drawn with 'below' and 'unit', which are defined here bit for bit.
+ */
+class Xoshiro256 {
+public:
+    using result_type = uint64_t;
+
+    explicit constexpr Xoshiro256(const uint64_t seed = 0) : state() {
+        this->seed(seed);
+    }
+
+    //Fills the state from 'value' through SplitMix64, as the authors of xoshiro recommend
+    constexpr void seed(uint64_t value) {
+        for (uint64_t& word : state) {
+            word = splitMix64(value);
+        }
+    }
+
+    constexpr result_type operator()() {
+        const uint64_t result = rotl(state[1] * 5, 7) * 9;
+        const uint64_t shifted = state[1] << 17;
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= shifted;
+        state[3] = rotl(state[3], 45);
+        return result;
+    }
+
+    /**
+     * Uniform number in [0, 'bound') from the upper 32 bits of the next output, by Lemire's multiply-and-reject:
+     * the few values which would make the result biased are drawn again. 'bound' must not be 0
+     */
+    constexpr uint32_t below(const uint32_t bound) {
+        uint64_t product = ((*this)() >> 32) * bound;
+        if ((uint32_t)product < bound) {
+            const uint32_t threshold = (0u - bound) % bound;
+            while ((uint32_t)product < threshold) {
+                product = ((*this)() >> 32) * bound;
+            }
+        }
+        return (uint32_t)(product >> 32);
+    }
+
+    //Uniform number in [0, 1) made of the upper 53 bits of the next output
+    constexpr double unit() {
+        return (double)((*this)() >> 11) * 0x1.0p-53;
+    }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+private:
+    static constexpr uint64_t rotl(const uint64_t value, const int bits) {
+        return (value << bits) | (value >> (64 - bits));
+    }
+
+    uint64_t state[4];
+};
+
+#endif //RANDOM_H
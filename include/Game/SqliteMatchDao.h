@@ -0,0 +1,41 @@
+#ifndef SQLITEMATCHDAO_H
+#define SQLITEMATCHDAO_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include "Database.h"
+#include "MatchDao.h"
+
+/**
+ * DAO class which handles storing and retrieving matches between users in a 'matches' table of 'database'.
+ * Connections are borrowed from 'database', which is shared with SqliteUserDAO
+ * 'matches' table consists of four columns: 'user1Id', 'score1', 'user2Id' and 'score2'
+ * where user ids reference 'id' column of 'users' table.
+ * Every row also keeps 'rounds' and 'moves' which is the packed MoveLog of the match, 'seed' of its game
+ * and 'variant' and 'players' of that game
+ */
+class SqliteMatchDAO final : public MatchDAO {
+public:
+    explicit SqliteMatchDAO(std::shared_ptr<Database> database);
+    ~SqliteMatchDAO() override = default;
+
+    int addMatch(const Match& match) const override;
+    void addMatches(const std::vector<Match>& matches, int firstId) const;
+    [[nodiscard]] int getMaxId() const;
+    [[nodiscard]] MoveLog getMoveLog(int matchId) const override;
+    [[nodiscard]] uint64_t getSeed(int matchId) const override;
+    [[nodiscard]] std::pair<std::string, int> getVariant(int matchId) const override;
+    [[nodiscard]] std::pair<double, double> getScores(int matchId) const override;
+    [[nodiscard]] std::pair<std::string, double> getAverageScore(int userId) const override;
+    [[nodiscard]] std::vector<std::pair<std::string, double>> getTopPlayers(int num) const override;
+    [[nodiscard]] std::unordered_map<int, std::pair<double, int>> getScoreTotals() const;
+
+private:
+    static int insertMatch(Database::Connection& connection, const Match& match, int id);
+
+    std::shared_ptr<Database> database;
+};
+
+#endif //SQLITEMATCHDAO_H
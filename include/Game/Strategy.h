@@ -0,0 +1,104 @@
+#ifndef STRATEGY_H
+#define STRATEGY_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "MoveLog.h"
+#include "Payoff.h"
+#include "Random.h"
+
+/**
+ * A player of the headless game kernel: decides every move from what happened in the previous round,
+ * with no sockets and no waiting. Built-in strategies are the classic ones from Axelrod's tournaments.
+ *
+ * 'reset' prepares the strategy for a new match, 'seed' drives whatever randomness the strategy has,
+ * so a match is fully determined by the two strategies, the number of rounds and the seeds.
+ */
+class Strategy {
+public:
+    virtual ~Strategy() = default;
+
+    [[nodiscard]] virtual std::string getName() const = 0;
+    [[nodiscard]] virtual std::unique_ptr<Strategy> clone() const = 0;
+    virtual void reset([[maybe_unused]] uint64_t seed) {}
+    //Move for round 'round', 'myLast' and 'opponentLast' are moves of the previous round and mean nothing in round 0
+    virtual Move next(int round, Move myLast, Move opponentLast) = 0;
+};
+
+//Implements 'clone' for a strategy which can simply be copied
+template <typename Derived>
+class CopyableStrategy : public Strategy {
+public:
+    [[nodiscard]] std::unique_ptr<Strategy> clone() const override {
+        return std::make_unique<Derived>(static_cast<const Derived&>(*this));
+    }
+};
+
+//Splits first, then repeats the previous move of the opponent
+class TitForTat final : public CopyableStrategy<TitForTat> {
+public:
+    [[nodiscard]] std::string getName() const override { return "TFT"; }
+    Move next(int round, Move myLast, Move opponentLast) override;
+};
+
+//Splits until the opponent steals once, then steals for the rest of the match
+class Grudger final : public CopyableStrategy<Grudger> {
+public:
+    [[nodiscard]] std::string getName() const override { return "Grudger"; }
+    void reset(uint64_t seed) override;
+    Move next(int round, Move myLast, Move opponentLast) override;
+
+private:
+    bool betrayed = false;
+};
+
+//Win-stay, lose-shift: keeps its move after a good round (opponent split), changes it after a bad one
+class Pavlov final : public CopyableStrategy<Pavlov> {
+public:
+    [[nodiscard]] std::string getName() const override { return "Pavlov"; }
+    Move next(int round, Move myLast, Move opponentLast) override;
+};
+
+//Splits or steals with equal probability
+class RandomStrategy final : public CopyableStrategy<RandomStrategy> {
+public:
+    [[nodiscard]] std::string getName() const override { return "Random"; }
+    void reset(uint64_t seed) override;
+    Move next(int round, Move myLast, Move opponentLast) override;
+
+private:
+    Xoshiro256 generator;
+};
+
+class AlwaysSplit final : public CopyableStrategy<AlwaysSplit> {
+public:
+    [[nodiscard]] std::string getName() const override { return "AllC"; }
+    Move next(int, Move, Move) override { return Move::SPLIT; }
+};
+
+class AlwaysSteal final : public CopyableStrategy<AlwaysSteal> {
+public:
+    [[nodiscard]] std::string getName() const override { return "AllD"; }
+    Move next(int, Move, Move) override { return Move::STEAL; }
+};
+
+//One instance of every built-in strategy
+std::vector<std::unique_ptr<Strategy>> builtinStrategies();
+
+//Built-in strategy whose 'getName' is 'name', nullptr if there is no such strategy
+std::unique_ptr<Strategy> makeStrategy(const std::string& name);
+
+/**
+ * Total coins of both players after a whole match
+ */
+struct MatchScore {
+    int score1 = 0;
+    int score2 = 0;
+};
+
+//Plays 'rounds' rounds between 'first' and 'second', records every round in 'log' if it is given
+MatchScore playMatch(Strategy& first, Strategy& second, int rounds, uint64_t seed, MoveLog* log = nullptr);
+
+#endif //STRATEGY_H
@@ -0,0 +1,36 @@
+#ifndef TOURNAMENT_H
+#define TOURNAMENT_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include "Strategy.h"
+
+/**
+ * Axelrod-style round-robin tournament between strategies of the headless game kernel.
+ * Every strategy meets every strategy (itself included) 'repetitions' times, each match lasting 'rounds' rounds.
+ * Matches are independent, so 'run' spreads them over 'threads' threads, each working on its own
+ * copies of the strategies and its own score totals which are merged only at the end.
+ *
+ * Seeds of all matches are derived from 'seed' and the position of the match in the schedule,
+ * so a tournament gives the same ranking whatever the number of threads is.
+ */
+class Tournament {
+public:
+    Tournament(std::vector<std::unique_ptr<Strategy>> strategies, int rounds, int repetitions, uint64_t seed = 0);
+    ~Tournament() = default;
+
+    [[nodiscard]] std::vector<std::pair<std::string, double>> run(int threads) const;
+    [[nodiscard]] long long getMatchCount() const;
+
+private:
+    std::vector<std::unique_ptr<Strategy>> strategies;
+    std::vector<std::pair<int, int>> pairings;
+    int rounds;
+    int repetitions;
+    uint64_t seed;
+};
+
+#endif //TOURNAMENT_H
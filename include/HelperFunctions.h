@@ -2,9 +2,18 @@
 #define HELPERFUNCTIONS_H
 
 #include <winsock2.h>
+#include <algorithm>
+#include <chrono>
+#include <ws2tcpip.h>
 #include <string>
+#include <thread>
 #include <vector>
-#include <queue>
+#include <deque>
+#include <memory>
+#include <unordered_set>
+#include "UsernameTable.h"
+#include "MoveInbox.h"
+#include "Outbox.h"
 
 /**
  * Wrapper of send function
@@ -15,69 +24,151 @@ inline void sendToClient(const SOCKET clientSocket, const std::string& message)
 
 /**
  * Wrapper of receive function
+ * Returns raw bytes of a single recv call, empty string means the client disconnected
  */
 inline std::string receiveFromClient(const SOCKET clientSocket) {
     char buffer[512];
-    if (const int result = recv(clientSocket, buffer, 512, 0); result > 0) {
-        buffer[result] = '\0';
-        std::string res = buffer;
-        return res;
+    if (const int result = recv(clientSocket, buffer, sizeof(buffer), 0); result > 0) {
+        return {buffer, (size_t)result};
     }
     return "";
 }
 
+//Longest line a client may send, anything longer is refused before it reaches the rest of the server
+constexpr size_t MAX_INPUT_LENGTH = 128;
+
+/**
+ * Validation stage every client line goes through right after it is received.
+ * Strips trailing CR/LF in place, then returns false if what is left is empty, longer than
+ * 'MAX_INPUT_LENGTH' or contains control characters. Code behind this stage may rely on short printable strings
+ */
+inline bool sanitizeInput(std::string& input) {
+    while (!input.empty() && (input.back() == '\n' || input.back() == '\r')) {
+        input.pop_back();
+    }
+    if (input.empty() || input.size() > MAX_INPUT_LENGTH) {
+        return false;
+    }
+    for (const char c : input) {
+        if ((unsigned char)c < ' ' || c == 127) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Returns textual IP address of the remote end of 'clientSocket', without the port,
+ * so every connection from the same machine maps to the same string. Returns empty string on failure
+ */
+inline std::string peerAddress(const SOCKET clientSocket) {
+    sockaddr_storage address{};
+    socklen_t length = sizeof(address);
+    if (getpeername(clientSocket, (sockaddr*)&address, &length) != 0) {
+        return "";
+    }
+
+    char text[INET6_ADDRSTRLEN] = {};
+    if (address.ss_family == AF_INET6) {
+        inet_ntop(AF_INET6, &((sockaddr_in6*)&address)->sin6_addr, text, sizeof(text));
+    } else {
+        inet_ntop(AF_INET, &((sockaddr_in*)&address)->sin_addr, text, sizeof(text));
+    }
+    return text;
+}
+
 /**
  * Takes vector of strings as a parameter and makes the simplest dialogue between server and user
  * Server starts the dialogue with the first string
  * Client responds
  * Server responds etc.
  *
- * Returns all answers of user
+ * Answers which do not pass 'sanitizeInput' are refused and, after a second like every other refusal,
+ * the same message is sent again. After 'MAX_INVALID_INPUTS' refused answers in a row the client is treated as gone
+ *
+ * Returns all answers of user, already sanitized, or empty vector if the user disconnected
  */
 inline std::vector<std::string> promptUser(const SOCKET clientSocket, const std::vector<std::string>& messages) {
+    constexpr int MAX_INVALID_INPUTS = 5;
     std::vector<std::string> userInput;
     for (const auto & message : messages) {
-        sendToClient(clientSocket, message);
-        std::string receiveString = receiveFromClient(clientSocket);
-        if (receiveString.empty()) {
-            return {};
+        for (int invalid = 0; ; invalid++) {
+            if (invalid == MAX_INVALID_INPUTS) {
+                return {};
+            }
+            sendToClient(clientSocket, message);
+            std::string receiveString = receiveFromClient(clientSocket);
+            if (receiveString.empty()) {
+                return {};
+            }
+            if (sanitizeInput(receiveString)) {
+                userInput.emplace_back(std::move(receiveString));
+                break;
+            }
+            sendToClient(clientSocket, "Invalid input, use at most " + std::to_string(MAX_INPUT_LENGTH) +
+                                       " printable characters.\n");
+            std::this_thread::sleep_for(std::chrono::seconds(1));
         }
-        userInput.emplace_back(receiveString);
     }
     return userInput;
 }
 
 /**
- * Takes arguments 'username' and queue 'matchmakingQueue' and returns true if and only if there exists a pair in
- * the queue which contains 'username'. Does not change 'matchmakingQueue'
+ * Single entry of the matchmaking queue: who is waiting (username handle and id of the user), the outbox of its
+ * connection, since when, the inbox its moves will arrive in and whether it talks the binary protocol.
+ * A client waiting for several games has one entry per game
  */
-inline bool findInQueue(const std::string& username, std::queue<std::pair<std::string, SOCKET>>& matchmakingQueue) {
-    std::queue<std::pair<std::string, SOCKET>> queue;
-    bool found = false;
-    while (!matchmakingQueue.empty()) {
-        auto pair = matchmakingQueue.front();
-        found |= pair.first == username;
-        matchmakingQueue.pop();
-        queue.push(pair);
-    }
-    matchmakingQueue = queue;
-    return found;
+struct QueueEntry {
+    Username username;
+    int userId;
+    std::shared_ptr<Outbox> outbox;
+    std::chrono::steady_clock::time_point queuedAt;
+    std::shared_ptr<MoveInbox> inbox;
+    bool binary = false;
+};
+
+/**
+ * Takes arguments 'username' and queue 'matchmakingQueue' and returns true if and only if there exists an entry in
+ * the queue which contains 'username'
+ */
+inline bool findInQueue(const Username username, const std::deque<QueueEntry>& matchmakingQueue) {
+    return std::ranges::find(matchmakingQueue, username, &QueueEntry::username) != matchmakingQueue.end();
 }
 
 /**
- * Takes arguments 'username' and queue 'matchmakingQueue' and removes the pair in
+ * Takes arguments 'username' and queue 'matchmakingQueue' and removes every entry in
  * the queue which contains 'username'. Changes 'matchmakingQueue'
  */
-inline void removeFromQueue(const std::string& username, std::queue<std::pair<std::string, SOCKET>>& matchmakingQueue) {
-    std::queue<std::pair<std::string, SOCKET>> queue;
-    while (!matchmakingQueue.empty()) {
-        auto pair = matchmakingQueue.front();
-        matchmakingQueue.pop();
-        if (pair.first != username) {
-            queue.push(pair);
+inline void removeFromQueue(const Username username, std::deque<QueueEntry>& matchmakingQueue) {
+    std::erase_if(matchmakingQueue, [&](const QueueEntry& entry) { return entry.username == username; });
+}
+
+/**
+ * Returns how many different users wait in 'matchmakingQueue', counting stops at 'limit'
+ */
+inline size_t countUsers(const std::deque<QueueEntry>& matchmakingQueue, const size_t limit) {
+    std::unordered_set<Username> users;
+    for (auto it = matchmakingQueue.begin(); it != matchmakingQueue.end() && users.size() < limit; ++it) {
+        users.insert(it->username);
+    }
+    return users.size();
+}
+
+/**
+ * Takes entries of up to 'seats' different users from the front of 'matchmakingQueue' and returns them,
+ * so a client waiting for several games never sits at the same table twice. Skipped entries keep their order
+ */
+inline std::vector<QueueEntry> takeTable(std::deque<QueueEntry>& matchmakingQueue, const size_t seats) {
+    std::vector<QueueEntry> table;
+    for (auto it = matchmakingQueue.begin(); it != matchmakingQueue.end() && table.size() < seats;) {
+        if (std::ranges::find(table, it->username, &QueueEntry::username) != table.end()) {
+            ++it;
+            continue;
         }
+        table.push_back(std::move(*it));
+        it = matchmakingQueue.erase(it);
     }
-    matchmakingQueue = queue;
+    return table;
 }
 
 inline std::string border = "--------------------\n";
@@ -6,32 +6,51 @@
 #include <string>
 #include <thread>
 #include <vector>
-#include <queue>
+#include <deque>
 #include <memory>
 #include <unordered_set>
 #include <mutex>
 #include <condition_variable>
 #include "ServerAuthenticator.h"
 #include "MatchDao.h"
+#include "HelperFunctions.h"
+#include "GameSession.h"
+#include "GameRules.h"
+#include "Outbox.h"
+#include "GameScheduler.h"
+#include "BotPlayer.h"
+#include "LiveTournament.h"
+#include <atomic>
+#include <functional>
+#include <map>
 
 #pragma comment(lib, "Ws2_32.lib")
 
+class Broadcast;
+
 /**
  * This is a Server Class, which is a main class in this project
  * Part of its methods are here to initialize the necessary sockets and setup for future connections.
  * Others are here to handle each connected client.
  *
  * The Server Class has 'ServerAuthenticator' object which helps it to login and register users.
- * 'activeUsers' store the usernames of clients who logged in successfully. This is here to control
+ * 'activeUsers' store the username handles of clients who logged in successfully. This is here to control
  * that no two clients can log in into the same user simultaneously.
  *
- * The Server Class also has 'GameSession' object which helps it to handle a game between 2 users.
- * 'playingUsers' store the usernames of clients who are currently in the game.
+ * Games are GameSessions stepped by the few threads of 'scheduler', moves reach them through MoveInbox
+ * and their messages leave through the Outbox of each connection, which its own thread flushes.
+ * A client is playing while a game has its connection's MoveInbox open, 'cvPlaying' is notified when a game releases it.
+ * Matchmaking, tournaments, spectators and the binary protocol are described at the methods serving them.
  */
 class Server {
 public:
+    static constexpr int MAX_GAMES_PER_CLIENT = 16;
+
     Server(std::string  ip, int port, std::shared_ptr<ServerAuthenticator> serverAuthenticator,
-            std::shared_ptr<MatchDAO> matchDAO);
+            std::shared_ptr<MatchDAO> matchDAO, std::vector<BotPlayer> bots = {},
+            std::chrono::milliseconds botWait = std::chrono::seconds(10),
+            const std::vector<GameRules>& variants = {GameRules()}, TournamentSettings tournaments = {},
+            int gameThreads = 2, uint64_t seed = 0);
     ~Server();
 
     void start();
@@ -42,7 +61,21 @@ private:
     void setupListeningSocket();
     void acceptConnections();
     void matchmakingLoop();
-    void mainMenuLoop(SOCKET clientSocket, const std::string& username);
+    void startGame(std::vector<Participant> table, const std::shared_ptr<const GameRules>& rules,
+                   std::function<void(const std::vector<int>&)> onFinished = nullptr);
+    void mainMenuLoop(SOCKET clientSocket, Username username, int userId);
+    std::pair<bool, bool> joinQueue(QueueEntry entry, size_t variant, int games);
+    bool relayMoves(SOCKET clientSocket, MoveInbox& inbox, Outbox& outbox, const std::function<bool()>& keepRelaying,
+                    FrameReceiver* frames = nullptr, const std::function<void(FrameReader&)>& onRequest = nullptr);
+    void waitForGames(const MoveInbox& inbox);
+    bool playTournament(SOCKET clientSocket, Username username, int userId);
+    void startTournament(const std::shared_ptr<LiveTournament>& tournament);
+    void startTournamentRound(const std::shared_ptr<LiveTournament>& tournament);
+    void reportTournamentGame(const std::shared_ptr<LiveTournament>& tournament, int first, int second,
+                              const std::vector<int>& scores);
+    bool watchGame(SOCKET clientSocket, int gameId);
+    std::string listGames();
+    void binaryClientLoop(SOCKET clientSocket, const std::string& clientAddress);
     void handleClient(SOCKET clientSocket);
 
     std::string ip;
@@ -52,21 +85,38 @@ private:
     std::vector<std::thread> clientThreads;
 
     std::mutex activeUsersMutex;
-    std::unordered_set<std::string> activeUsers;
+    std::unordered_set<Username> activeUsers;
     std::shared_ptr<ServerAuthenticator> authenticator;
 
     std::mutex matchmakingMutex;
     std::condition_variable cvMatchMaking;
     std::condition_variable cvHandleClient;
-    std::queue<std::pair<std::string, SOCKET>> matchmakingQueue;
+    std::vector<std::deque<QueueEntry>> matchmakingQueues;
     std::thread matchmakingThread;
+    std::atomic<int> nextGameId = 1;
+    uint64_t seed;
 
     std::mutex playingMutex;
     std::condition_variable cvPlaying;
-    std::unordered_set<std::string> playingUsers;
 
-    std::mutex matchDaoMutex;
+    std::mutex broadcastsMutex;
+    std::map<int, std::shared_ptr<Broadcast>> broadcasts;
+
     std::shared_ptr<MatchDAO> matchDAO;
+
+    std::vector<BotPlayer> bots;
+    std::chrono::milliseconds botWait;
+    size_t nextBot = 0;
+
+    std::vector<std::shared_ptr<const GameRules>> variants;
+
+    std::mutex tournamentsMutex;
+    TournamentSettings tournaments;
+    std::shared_ptr<const GameRules> tournamentRules;
+    std::shared_ptr<LiveTournament> formingTournament;
+    int nextTournamentId = 1;
+
+    GameScheduler scheduler;
 };
 
 #endif // SERVER_H
@@ -3,11 +3,23 @@
 #include <memory>
 
 #include "AuthHandler.h"
-#include "LengthChecker.h"
-#include "UpperCaseChecker.h"
-#include "LowerCaseChecker.h"
+#include "PasswordPolicy.h"
+#include "RuntimePasswordPolicy.h"
+#include "BlocklistChecker.h"
 #include "Server.h"
+#include "SqliteUserDao.h"
+#include "InMemoryUserDao.h"
+#include "CachedUserDao.h"
+#include "SqliteMatchDao.h"
+#include "JournalMatchDao.h"
+#include "InMemoryMatchDao.h"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
 #include <csignal>
+#include <optional>
+#include <random>
+#include <sstream>
 
 Server* globalServer = nullptr;
 
@@ -17,25 +29,307 @@ void signalHandler(int signal) {
     }
 }
 
-int main() {
+namespace {
+    //Reads the whole number after '=' of "--option=value" 'arg' into 'number', false if it is not one or out of range
+    template <typename Number>
+    bool parseNumber(const std::string& arg, Number& number) {
+        const std::string_view value = std::string_view(arg).substr(arg.find('=') + 1);
+        const auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), number);
+        return error == std::errc() && end == value.data() + value.size();
+    }
+}
+
+/**
+ * Startup options:
+ * --user-store=sqlite|memory    where users are stored, 'sqlite' by default
+ * --match-store=sqlite|journal|memory  where matches are stored, 'sqlite' by default.
+ *                               'sqlite' and 'journal' need 'sqlite' user store, 'memory' works with both
+ * --journal=<path>              path of the match journal used by 'journal' store
+ * --export-journal              moves all journaled matches into SQLite 'Matches' table and exits
+ * --user-cache=<n>             users kept in the read-through user cache, 10000 by default, 0 disables it
+ * --session-secret=<text>     key which signs session tokens, random by default (tokens then die with the server)
+ * --session-ttl=<seconds>      how long a session token stays valid, 3600 by default
+ * --address-limit=<n>          login/registration attempts per minute from one IP address, 30 by default, 0 disables
+ * --account-limit=<n>          login attempts per minute for one account, 10 by default, 0 disables
+ * --password-policy=<spec>     password rules such as "length=8,upper,lower,digit,symbol" (see RuntimePasswordPolicy),
+ *                               by default the built-in policy: at least 8 characters, upper-case and lower-case letter
+ * --blocklist=<path>           filter built by BuildBlocklist, passwords found in it are refused at registration
+ * --bots=<names>               strategies of server-side bots (see Strategy.h), "TFT,Pavlov,Grudger,Random" by default,
+ *                               empty list disables bots
+ * --bot-wait=<seconds>          how long a client waits for a human opponent before getting a bot, 10 by default
+ * --variant=<spec>              game variant such as "noisy:payoff=3/0/5/1,rounds=5-10,noise=0.05" (see GameRules),
+ *                               may be repeated, each variant gets its own queue and the first one is the default.
+ *                               Without any only the classic game is played
+ * --tournament=swiss|round-robin  bracket format of tournaments, 'swiss' by default
+ * --tournament-size=<n>         entrants which start a tournament, 8 by default
+ * --tournament-wait=<seconds>   longest wait for a tournament to fill up before it starts anyway, 60 by default
+ * --game-threads=<n>            threads which run all games, 2 by default
+ * --seed=<n>                    seed every game's randomness is derived from, random by default (printed at startup)
+ * --replay=<match id>           checks a stored match against its seed, variant and scores, prints it and exits
+ * --hash-iterations=<n>         PBKDF2 iterations for new password hashes, 100000 by default
+ * --hash-threads=<n>            threads which hash passwords, 2 by default
+ * --hash-queue=<n>              logins/registrations waiting for hashing before new ones are refused, 64 by default
+ */
+int main(int argc, char* argv[]) {
     std::signal(SIGINT, signalHandler);
 
     std::string dbPath = "../database.sqlite";
+    std::string userStore = "sqlite";
+    std::string matchStore = "sqlite";
+    std::string journalPath = "../matches.journal";
+    bool exportJournal = false;
+    int userCache = 10000;
+    std::string sessionSecret = SessionManager::randomSecret();
+    int sessionTtl = 3600;
+    int addressLimit = 30;
+    int accountLimit = 10;
+    std::string passwordPolicy;
+    std::string blocklistPath;
+    std::string botNames = "TFT,Pavlov,Grudger,Random";
+    int botWait = 10;
+    std::vector<std::string> variantSpecs;
+    std::string tournamentFormat = "swiss";
+    int tournamentSize = 8;
+    int tournamentWait = 60;
+    int gameThreads = 2;
+    std::optional<uint64_t> seed;
+    int replayMatch = 0;
+    int hashIterations = 100000;
+    int hashThreads = 2;
+    int hashQueue = 64;
+    for (int i = 1; i < argc; i++) {
+        bool valid = true;
+        if (const std::string arg = argv[i]; arg.starts_with("--user-store=")) {
+            userStore = arg.substr(arg.find('=') + 1);
+        } else if (arg.starts_with("--match-store=")) {
+            matchStore = arg.substr(arg.find('=') + 1);
+        } else if (arg.starts_with("--journal=")) {
+            journalPath = arg.substr(arg.find('=') + 1);
+        } else if (arg == "--export-journal") {
+            exportJournal = true;
+        } else if (arg.starts_with("--user-cache=")) {
+            valid = parseNumber(arg, userCache);
+        } else if (arg.starts_with("--session-secret=")) {
+            sessionSecret = arg.substr(arg.find('=') + 1);
+        } else if (arg.starts_with("--session-ttl=")) {
+            valid = parseNumber(arg, sessionTtl);
+        } else if (arg.starts_with("--address-limit=")) {
+            valid = parseNumber(arg, addressLimit);
+        } else if (arg.starts_with("--account-limit=")) {
+            valid = parseNumber(arg, accountLimit);
+        } else if (arg.starts_with("--password-policy=")) {
+            passwordPolicy = arg.substr(arg.find('=') + 1);
+        } else if (arg.starts_with("--blocklist=")) {
+            blocklistPath = arg.substr(arg.find('=') + 1);
+        } else if (arg.starts_with("--bots=")) {
+            botNames = arg.substr(arg.find('=') + 1);
+        } else if (arg.starts_with("--bot-wait=")) {
+            valid = parseNumber(arg, botWait);
+        } else if (arg.starts_with("--variant=")) {
+            variantSpecs.push_back(arg.substr(arg.find('=') + 1));
+        } else if (arg.starts_with("--tournament=")) {
+            tournamentFormat = arg.substr(arg.find('=') + 1);
+        } else if (arg.starts_with("--tournament-size=")) {
+            valid = parseNumber(arg, tournamentSize);
+        } else if (arg.starts_with("--tournament-wait=")) {
+            valid = parseNumber(arg, tournamentWait);
+        } else if (arg.starts_with("--game-threads=")) {
+            valid = parseNumber(arg, gameThreads);
+        } else if (arg.starts_with("--seed=")) {
+            valid = parseNumber(arg, seed.emplace());
+        } else if (arg.starts_with("--replay=")) {
+            valid = parseNumber(arg, replayMatch);
+        } else if (arg.starts_with("--hash-iterations=")) {
+            valid = parseNumber(arg, hashIterations);
+        } else if (arg.starts_with("--hash-threads=")) {
+            valid = parseNumber(arg, hashThreads);
+        } else if (arg.starts_with("--hash-queue=")) {
+            valid = parseNumber(arg, hashQueue);
+        } else {
+            std::cerr << "Unknown option: " << arg << std::endl;
+            return 1;
+        }
+        if (!valid) {
+            std::cerr << "Invalid value for " << argv[i] << std::endl;
+            return 1;
+        }
+    }
+
+    std::shared_ptr<Database> database;
+    std::shared_ptr<UserDAO> userDao;
+    if (userStore == "sqlite") {
+        database = std::make_shared<Database>(dbPath);
+        userDao = std::make_shared<SqliteUserDAO>(database);
+    } else if (userStore == "memory") {
+        userDao = std::make_shared<InMemoryUserDAO>();
+    } else {
+        std::cerr << "Unknown user store: " << userStore << std::endl;
+        return 1;
+    }
+
+    if (userCache > 0) {
+        userDao = std::make_shared<CachedUserDAO>(userDao, userCache);
+    }
 
-    const auto userDao = std::make_shared<UserDAO>(dbPath);
-    const auto matchDao = std::make_shared<MatchDAO>(dbPath);
+    if ((matchStore == "sqlite" || matchStore == "journal" || exportJournal) && userStore != "sqlite") {
+        std::cerr << "Match store '" << matchStore << "' needs '--user-store=sqlite'" << std::endl;
+        return 1;
+    }
 
-    auto const lowerCaseChecker = std::make_shared<LowerCaseChecker>();
-    auto const upperCaseChecker = std::make_shared<UpperCaseChecker>(lowerCaseChecker);
-    auto const lengthChecker = std::make_shared<LengthChecker>(8, upperCaseChecker);
+    if (exportJournal) {
+        JournalMatchDAO journal(journalPath, userDao, std::make_shared<SqliteMatchDAO>(database));
+        std::cout << "Exported " << journal.exportToArchive() << " matches from " << journalPath << std::endl;
+        return 0;
+    }
 
-    const auto authHandler = std::make_shared<AuthHandler>(userDao, lengthChecker);
-    const auto serverAuthenticator = std::make_shared<ServerAuthenticator>(authHandler);
+    std::shared_ptr<MatchDAO> matchDao;
+    if (matchStore == "sqlite") {
+        matchDao = std::make_shared<SqliteMatchDAO>(database);
+    } else if (matchStore == "journal") {
+        matchDao = std::make_shared<JournalMatchDAO>(journalPath, userDao, std::make_shared<SqliteMatchDAO>(database));
+    } else if (matchStore == "memory") {
+        matchDao = std::make_shared<InMemoryMatchDAO>(userDao);
+    } else {
+        std::cerr << "Unknown match store: " << matchStore << std::endl;
+        return 1;
+    }
+
+    using DefaultPolicy = PasswordPolicy<MinLength<8>, RequireUpperCase, RequireLowerCase>;
+    std::shared_ptr<PasswordChecker> passwordChecker = std::make_shared<PolicyChecker<DefaultPolicy>>();
+    if (!passwordPolicy.empty()) {
+        try {
+            passwordChecker = std::make_shared<RuntimePasswordPolicy>(passwordPolicy);
+        } catch (const std::invalid_argument& e) {
+            std::cerr << "Invalid password policy: " << e.what() << std::endl;
+            return 1;
+        }
+    }
+    if (!blocklistPath.empty()) {
+        passwordChecker = std::make_shared<BlocklistChecker>(std::make_shared<BlocklistFilter>(blocklistPath),
+                                                             passwordChecker);
+    }
 
-    Server server("127.0.0.1", 54000, serverAuthenticator, matchDao);
+    const auto passwordHasher = std::make_shared<PasswordHasher>(hashIterations);
+    const auto hashingPool = std::make_shared<HashingPool>(hashThreads, hashQueue);
+    const auto authHandler = std::make_shared<AuthHandler>(userDao, passwordChecker, passwordHasher, hashingPool);
+    const auto sessionManager = std::make_shared<SessionManager>(sessionSecret, std::chrono::seconds(sessionTtl));
+    //Both limiters allow a whole minute worth of attempts at once, then refill evenly over the minute
+    //(in microseconds, so limits above 60000 per minute do not refill instantly)
+    const auto perMinute = [](const int limit) {
+        const auto interval = std::chrono::microseconds(std::max(60000000 / std::max(limit, 1), 1));
+        return limit > 0 ? std::make_shared<RateLimiter>(limit, interval) : nullptr;
+    };
+    const auto usernames = std::make_shared<UsernameTable>();
+    const auto serverAuthenticator = std::make_shared<ServerAuthenticator>(authHandler, sessionManager,
+                                                                           perMinute(addressLimit), perMinute(accountLimit),
+                                                                           usernames);
+
+    //Bots play under accounts like "bot:TFT", ':' is not allowed in new usernames, so no client can register one,
+    //and their passwords are random secrets nobody knows
+    std::vector<BotPlayer> bots;
+    std::stringstream botList(botNames);
+    for (std::string name; std::getline(botList, name, ',');) {
+        auto strategy = makeStrategy(name);
+        if (!strategy) {
+            std::cerr << "Unknown bot strategy: " << name << std::endl;
+            return 1;
+        }
+        const std::string botName = "bot:" + name;
+        int botId = userDao->getUserByName(botName).getId();
+        if (botId == 0) {
+            botId = userDao->addUser(User(botName, passwordHasher->hash(SessionManager::randomSecret())));
+        }
+        bots.push_back({usernames->intern(botName), botId, std::move(strategy)});
+    }
+
+    std::vector<GameRules> variants;
+    for (const std::string& spec : variantSpecs) {
+        try {
+            GameRules rules = GameRules::parse(spec);
+            if (std::ranges::any_of(variants, [&](const GameRules& other) { return other.getName() == rules.getName(); })) {
+                throw std::invalid_argument("variant " + rules.getName() + " is given twice");
+            }
+            variants.push_back(std::move(rules));
+        } catch (const std::exception& e) {
+            std::cerr << "Invalid game variant: " << e.what() << std::endl;
+            return 1;
+        }
+    }
+    if (variants.empty()) {
+        variants.emplace_back();
+    }
+
+    //A match is only replayed by the rules it was played with: its variant must still be configured with the same
+    //table size (tournaments play the classic game when no two player variant is configured)
+    if (replayMatch > 0) {
+        const MoveLog moves = matchDao->getMoveLog(replayMatch);
+        const uint64_t matchSeed = matchDao->getSeed(replayMatch);
+        const auto [variantName, players] = matchDao->getVariant(replayMatch);
+        const auto [score1, score2] = matchDao->getScores(replayMatch);
+        try {
+            if (moves.getRounds() == 0) {
+                throw std::runtime_error("there is no such match or it was stored without moves");
+            }
+            if (variantName.empty()) {
+                throw std::runtime_error("it was stored without its variant, it can not be verified");
+            }
+            const auto found = std::ranges::find_if(variants, [&](const GameRules& rules) {
+                return rules.getName() == variantName;
+            });
+            const GameRules rules = found != variants.end() ? *found : GameRules();
+            if (rules.getName() != variantName) {
+                throw std::runtime_error("it was played in variant " + variantName + ", which is not configured");
+            }
+            if (rules.getPlayers() != players) {
+                throw std::runtime_error("it was played at a table of " + std::to_string(players) + ", variant " +
+                                         variantName + " seats " + std::to_string(rules.getPlayers()) + " now");
+            }
+            const auto [coins1, coins2] = rules.replay(matchSeed, moves);
+            //The stored scores are the coins divided by the rounds, computed the same way they are here
+            const double rounds = moves.getRounds();
+            if (std::abs(coins1 / rounds - score1) > 1e-9 || std::abs(coins2 / rounds - score2) > 1e-9) {
+                throw std::runtime_error("it replays to average scores " + std::to_string(coins1 / rounds) + " / " +
+                                         std::to_string(coins2 / rounds) + " but was stored with " +
+                                         std::to_string(score1) + " / " + std::to_string(score2));
+            }
+            for (int round = 0; round < moves.getRounds(); round++) {
+                const auto [move1, move2] = moves.getRound(round);
+                std::cout << "Round " << round + 1 << ": " << (move1 == Move::STEAL ? "STEAL" : "SPLIT") << " / "
+                          << (move2 == Move::STEAL ? "STEAL" : "SPLIT") << std::endl;
+            }
+            std::cout << "Match " << replayMatch << " (seed " << matchSeed << ") replays to " << coins1 << " / "
+                      << coins2 << " coins" << std::endl;
+        } catch (const std::exception& e) {
+            std::cerr << "Match " << replayMatch << ": " << e.what() << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    TournamentSettings tournaments;
+    try {
+        tournaments.format = Bracket::parseFormat(tournamentFormat);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    tournaments.players = std::max(2, tournamentSize);
+    tournaments.wait = std::chrono::seconds(tournamentWait);
+
+    if (!seed) {
+        std::random_device device;
+        seed = (uint64_t)device() << 32 | device();
+    }
+    std::cout << "Game seed: " << *seed << std::endl;
+
+    Server server("127.0.0.1", 54000, serverAuthenticator, matchDao, bots, std::chrono::seconds(botWait), variants,
+                  tournaments, gameThreads, *seed);
     globalServer = &server;
     server.start();
 
+    const auto metrics = hashingPool->getMetrics();
+    std::cout << "Password hashing: " << metrics.completed << " jobs, " << metrics.rejected << " rejected, "
+              << "avg wait " << metrics.averageWaitMs << " ms, avg hash " << metrics.averageRunMs << " ms, "
+              << "max hash " << metrics.maxRunMs << " ms, peak queue " << metrics.peakQueueDepth << std::endl;
     return 0;
 }
-
@@ -1,40 +1,71 @@
 #include "AuthHandler.h"
+#include "UsernameTable.h"
 #include <utility>
 
-AuthHandler::AuthHandler(std::shared_ptr<UserDAO> dao, std::shared_ptr<PasswordChecker> checker)
-    : userDao(std::move(dao)), passwordChecker(std::move(checker)) {}
+namespace {
+    const std::string BUSY_MESSAGE = "Server is busy, try again later.";
+}
+
+AuthHandler::AuthHandler(std::shared_ptr<UserDAO> dao, std::shared_ptr<PasswordChecker> checker,
+                         std::shared_ptr<PasswordHasher> hasher, std::shared_ptr<HashingPool> pool)
+    : userDao(std::move(dao)), passwordChecker(std::move(checker)),
+      passwordHasher(std::move(hasher)), hashingPool(std::move(pool)) {}
 
 /**
  * Handles logging of a user.
- * Checks if 'username' does exist.
+ * Checks if 'username' does exist. The username rules are not applied here, accounts registered
+ * before the rules existed keep logging in with their names.
  * Checks if 'password' matches the one which was typed during registration.
+ * Users stored before hashing existed (plain text passwords) or hashed with another cost
+ * get their password rehashed in the background after a successful login.
  *
- * Returns corresponding message for each scenario
+ * Returns corresponding message for each scenario paired with the id of the user,
+ * id is 0 unless the user logged in successfully
  */
-std::string AuthHandler::loginUser(const std::string &username, const std::string &password) const {
+std::pair<std::string, int> AuthHandler::loginUser(const std::string &username, const std::string &password) const {
     const User user = userDao->getUserByName(username);
     if (user.getUsername().empty()) {
-        return "User " + username + " does not exist.";
+        return {"User " + username + " does not exist.", 0};
     }
 
-    if (password != user.getPassword()) {
-        return "User " + username + " does not match password.";
+    const std::string stored = user.getPassword();
+    auto verification = hashingPool->trySubmit([hasher = passwordHasher, password, stored]() {
+        return PasswordHasher::isHash(stored) ? hasher->verify(password, stored) : password == stored;
+    });
+    if (!verification) {
+        return {BUSY_MESSAGE, 0};
+    }
+    if (!verification->get()) {
+        return {"User " + username + " does not match password.", 0};
     }
 
-    return "User " + username + " logged in successfully";
+    if (passwordHasher->needsRehash(stored)) {
+        (void)hashingPool->trySubmit([hasher = passwordHasher, dao = userDao, id = user.getId(), password]() {
+            dao->updatePassword(id, hasher->hash(password));
+        });
+    }
+
+    return {"User " + username + " logged in successfully", user.getId()};
 }
 
 /**
  * Handles registering of a user.
+ * Checks if 'username' follows the username rules (see UsernameTable)
  * Checks if 'password' and 'repeated_password' match
  * Checks if 'password' passed all checks of 'passwordChecker' chain
- * Checks if 'username' already exists in 'users' table
  * On a successful registration, adds user in a table using 'userDao'
+ * Uniqueness of 'username' is enforced by 'userDao' itself, so two clients registering the same name
+ * at the same time can not both succeed
  *
  * Returns corresponding message for each scenario
  */
 std::string AuthHandler::registerUser(const std::string &username,
                                       const std::string &password, const std::string &repeated_password) const {
+    if (!UsernameTable::isValid(username)) {
+        return "Username must be " + std::to_string(UsernameTable::MIN_LENGTH) + "-" +
+               std::to_string(UsernameTable::MAX_LENGTH) + " characters long and contain only letters, digits, '_', '-' or '.'.";
+    }
+
     if (password != repeated_password) {
         return "Passwords do not match.";
     }
@@ -43,11 +74,21 @@ std::string AuthHandler::registerUser(const std::string &username,
         return validationError;
     }
 
-    if (const User user = userDao->getUserByName(username); !user.getUsername().empty()) {
-        return "Username " + username + " already exists.";
+    auto hashed = hashingPool->trySubmit([hasher = passwordHasher, password]() {
+        return hasher->hash(password);
+    });
+    if (!hashed) {
+        return BUSY_MESSAGE;
     }
 
-    const auto newUser = User(username, password);
-    userDao->addUser(newUser);
+    const auto newUser = User(username, hashed->get());
+    if (userDao->addUser(newUser) == 0) {
+        return "Username " + username + " already exists.";
+    }
     return "User " + username + " registered successfully.";
 }
+
+//Returns the name of the user with id 'userId' or empty string if there is no such user
+std::string AuthHandler::usernameOf(const int userId) const {
+    return userDao->getUserById(userId).getUsername();
+}
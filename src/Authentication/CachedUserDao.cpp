@@ -0,0 +1,80 @@
+#include "CachedUserDao.h"
+#include <algorithm>
+
+CachedUserDAO::CachedUserDAO(std::shared_ptr<UserDAO> userDao, const size_t capacity)
+    : userDao(std::move(userDao)), capacityPerShard(std::max<size_t>(1, capacity / SHARDS)) {}
+
+CachedUserDAO::Shard& CachedUserDAO::shardOf(const std::string& username) const {
+    return shards[std::hash<std::string>{}(username) % SHARDS];
+}
+
+//puts 'user' in front of the LRU under 'username' and evicts the least recently used entry if the shard is full
+void CachedUserDAO::store(Shard& shard, const std::string& username, const User& user) const {
+    if (const auto it = shard.index.find(username); it != shard.index.end()) {
+        *it->second = user;
+        shard.entries.splice(shard.entries.begin(), shard.entries, it->second);
+        return;
+    }
+    shard.entries.push_front(user);
+    shard.index[username] = shard.entries.begin();
+    if (shard.entries.size() > capacityPerShard) {
+        shard.index.erase(shard.entries.back().getUsername());
+        shard.entries.pop_back();
+    }
+}
+
+/**
+ * Returns cached user (or cached 'default' User if the name does not exist),
+ * on a miss asks 'userDao' and caches the answer
+ */
+User CachedUserDAO::getUserByName(const std::string& username) const {
+    auto& shard = shardOf(username);
+    unsigned long long version;
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        if (const auto it = shard.index.find(username); it != shard.index.end()) {
+            shard.entries.splice(shard.entries.begin(), shard.entries, it->second);
+            return it->second->getId() == 0 ? User("", "") : *it->second;
+        }
+        version = shard.version;
+    }
+
+    const User user = userDao->getUserByName(username);
+
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    if (shard.version == version) {
+        // "does not exist" entries keep the looked up name (with id 0), so eviction can find them in 'index'
+        store(shard, username, user.getUsername().empty() ? User(username, "", 0) : user);
+    }
+    return user;
+}
+
+User CachedUserDAO::getUserById(const int id) const {
+    return userDao->getUserById(id);
+}
+
+//Adds user through 'userDao' and drops a cached "does not exist" answer for its name
+int CachedUserDAO::addUser(const User& user) const {
+    const int id = userDao->addUser(user);
+    auto& shard = shardOf(user.getUsername());
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    shard.version++;
+    if (const auto it = shard.index.find(user.getUsername()); it != shard.index.end()) {
+        shard.entries.erase(it->second);
+        shard.index.erase(it);
+    }
+    return id;
+}
+
+//Updates password through 'userDao' and drops the cached entry of the user
+void CachedUserDAO::updatePassword(const int id, const std::string& password) const {
+    userDao->updatePassword(id, password);
+    const std::string username = userDao->getUserById(id).getUsername();
+    auto& shard = shardOf(username);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    shard.version++;
+    if (const auto it = shard.index.find(username); it != shard.index.end()) {
+        shard.entries.erase(it->second);
+        shard.index.erase(it);
+    }
+}
@@ -0,0 +1,74 @@
+#include "HashingPool.h"
+
+HashingPool::HashingPool(const int threads, const int maxQueueDepth)
+    : maxQueueDepth(maxQueueDepth) {
+    for (int i = 0; i < threads; i++) {
+        workers.emplace_back(&HashingPool::workerLoop, this);
+    }
+}
+
+//lets workers finish every queued job and joins them
+HashingPool::~HashingPool() {
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stopping = true;
+    }
+    cvQueue.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+bool HashingPool::tryPush(std::function<void()> job) {
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        if (stopping || (int)queue.size() >= maxQueueDepth) {
+            ++rejected;
+            return false;
+        }
+        queue.push_back({std::move(job), std::chrono::steady_clock::now()});
+        if ((int)queue.size() > peakQueueDepth) {
+            peakQueueDepth = (int)queue.size();
+        }
+    }
+    cvQueue.notify_one();
+    return true;
+}
+
+void HashingPool::workerLoop() {
+    while (true) {
+        QueuedJob queued;
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            cvQueue.wait(lock, [&]() { return stopping || !queue.empty(); });
+            if (queue.empty()) {
+                return;
+            }
+            queued = std::move(queue.front());
+            queue.pop_front();
+        }
+
+        const auto started = std::chrono::steady_clock::now();
+        queued.job();
+        const auto finished = std::chrono::steady_clock::now();
+
+        const long long runNs = std::chrono::duration_cast<std::chrono::nanoseconds>(finished - started).count();
+        totalWaitNs += std::chrono::duration_cast<std::chrono::nanoseconds>(started - queued.queuedAt).count();
+        totalRunNs += runNs;
+        long long previousMax = maxRunNs;
+        while (runNs > previousMax && !maxRunNs.compare_exchange_weak(previousMax, runNs)) {}
+        ++completed;
+    }
+}
+
+HashingPool::Metrics HashingPool::getMetrics() const {
+    int queueDepth;
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        queueDepth = (int)queue.size();
+    }
+    const long long done = completed;
+    const double perJob = done == 0 ? 0.0 : 1e-6 / (double)done;
+    return {done, rejected, queueDepth, peakQueueDepth,
+            (double)totalWaitNs * perJob, (double)totalRunNs * perJob, (double)maxRunNs * 1e-6};
+}
@@ -0,0 +1,58 @@
+#include "InMemoryUserDao.h"
+#include <mutex>
+
+User InMemoryUserDAO::getUserByName(const std::string& username) const {
+    const auto& shard = byName[std::hash<std::string>{}(username) % SHARDS];
+    std::shared_lock lock(shard.mutex);
+    if (const auto it = shard.users.find(username); it != shard.users.end()) {
+        return it->second;
+    }
+    return {"", ""};
+}
+
+User InMemoryUserDAO::getUserById(const int id) const {
+    const auto& shard = byId[(size_t)id % SHARDS];
+    std::shared_lock lock(shard.mutex);
+    if (const auto it = shard.users.find(id); it != shard.users.end()) {
+        return it->second;
+    }
+    return {"", ""};
+}
+
+//Adds user with unique username and returns the id assigned to it, returns 0 if the username is taken
+int InMemoryUserDAO::addUser(const User& user) const {
+    auto& nameShard = byName[std::hash<std::string>{}(user.getUsername()) % SHARDS];
+    int id;
+    {
+        std::unique_lock lock(nameShard.mutex);
+        if (nameShard.users.contains(user.getUsername())) {
+            return 0;
+        }
+        id = nextId++;
+        nameShard.users.emplace(user.getUsername(), User(user.getUsername(), user.getPassword(), id));
+    }
+
+    auto& idShard = byId[(size_t)id % SHARDS];
+    std::unique_lock lock(idShard.mutex);
+    idShard.users.emplace(id, User(user.getUsername(), user.getPassword(), id));
+    return id;
+}
+
+//Replaces stored password of the user with id 'id', does nothing if there is no such user
+void InMemoryUserDAO::updatePassword(const int id, const std::string& password) const {
+    std::string username;
+    {
+        auto& idShard = byId[(size_t)id % SHARDS];
+        std::unique_lock lock(idShard.mutex);
+        const auto it = idShard.users.find(id);
+        if (it == idShard.users.end()) {
+            return;
+        }
+        username = it->second.getUsername();
+        it->second = User(username, password, id);
+    }
+
+    auto& nameShard = byName[std::hash<std::string>{}(username) % SHARDS];
+    std::unique_lock lock(nameShard.mutex);
+    nameShard.users.insert_or_assign(username, User(username, password, id));
+}
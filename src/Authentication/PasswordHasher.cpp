@@ -0,0 +1,262 @@
+#include "PasswordHasher.h"
+
+#include <random>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+    const std::string PREFIX = "pbkdf2-sha256$";
+    constexpr size_t SALT_SIZE = 16;
+
+    constexpr uint32_t K[64] = {
+        0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+        0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+        0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+        0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+        0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+        0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+        0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+        0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+    };
+
+    constexpr uint32_t rotr(const uint32_t x, const int n) {
+        return x >> n | x << (32 - n);
+    }
+
+    void compress(uint32_t state[8], const uint8_t block[64]) {
+        uint32_t w[64];
+        for (int i = 0; i < 16; i++) {
+            w[i] = (uint32_t)block[i * 4] << 24 | (uint32_t)block[i * 4 + 1] << 16 |
+                   (uint32_t)block[i * 4 + 2] << 8 | (uint32_t)block[i * 4 + 3];
+        }
+        for (int i = 16; i < 64; i++) {
+            const uint32_t s0 = rotr(w[i - 15], 7) ^ rotr(w[i - 15], 18) ^ w[i - 15] >> 3;
+            const uint32_t s1 = rotr(w[i - 2], 17) ^ rotr(w[i - 2], 19) ^ w[i - 2] >> 10;
+            w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+        }
+
+        uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+        uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+        for (int i = 0; i < 64; i++) {
+            const uint32_t t1 = h + (rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25)) + ((e & f) ^ (~e & g)) + K[i] + w[i];
+            const uint32_t t2 = (rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+            h = g;
+            g = f;
+            f = e;
+            e = d + t1;
+            d = c;
+            c = b;
+            b = a;
+            a = t1 + t2;
+        }
+        state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+        state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+    }
+
+    std::string toHex(const uint8_t* data, const size_t size) {
+        constexpr char digits[] = "0123456789abcdef";
+        std::string hex;
+        hex.reserve(size * 2);
+        for (size_t i = 0; i < size; i++) {
+            hex += digits[data[i] >> 4];
+            hex += digits[data[i] & 15];
+        }
+        return hex;
+    }
+
+    std::string fromHex(const std::string& hex) {
+        if (hex.size() % 2 != 0) {
+            throw std::invalid_argument("Odd length hex string");
+        }
+        std::string bytes;
+        for (size_t i = 0; i < hex.size(); i += 2) {
+            bytes += (char)std::stoi(hex.substr(i, 2), nullptr, 16);
+        }
+        return bytes;
+    }
+
+    constexpr uint32_t INITIAL_STATE[8] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+                                           0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+
+    void storeDigest(const uint32_t state[8], uint8_t digest[32]) {
+        for (int i = 0; i < 8; i++) {
+            digest[i * 4] = (uint8_t)(state[i] >> 24);
+            digest[i * 4 + 1] = (uint8_t)(state[i] >> 16);
+            digest[i * 4 + 2] = (uint8_t)(state[i] >> 8);
+            digest[i * 4 + 3] = (uint8_t)state[i];
+        }
+    }
+
+    /**
+     * HMAC-SHA256 state after the key blocks are absorbed. PBKDF2 computes HMAC of 32-byte messages
+     * with the same key many times, with precomputed pads each of them takes only two compressions
+     */
+    struct HmacKey {
+        uint32_t inner[8];
+        uint32_t outer[8];
+
+        explicit HmacKey(const std::string& key) {
+            uint8_t block[64] = {};
+            if (key.size() > 64) {
+                const auto hashed = PasswordHasher::sha256((const uint8_t*)key.data(), key.size());
+                std::memcpy(block, hashed.data(), hashed.size());
+            } else {
+                std::memcpy(block, key.data(), key.size());
+            }
+            uint8_t innerPad[64], outerPad[64];
+            for (int i = 0; i < 64; i++) {
+                innerPad[i] = block[i] ^ 0x36;
+                outerPad[i] = block[i] ^ 0x5c;
+            }
+            std::memcpy(inner, INITIAL_STATE, sizeof(inner));
+            std::memcpy(outer, INITIAL_STATE, sizeof(outer));
+            compress(inner, innerPad);
+            compress(outer, outerPad);
+        }
+
+        //HMAC of exactly 32 bytes of 'message', result is written back into 'message'
+        void apply(uint8_t message[32]) const {
+            uint8_t block[64] = {};
+            block[32] = 0x80;
+            block[62] = 0x03; // message length: (64 + 32) * 8 = 768 bits
+            for (const uint32_t* start : {inner, outer}) {
+                uint32_t state[8];
+                std::memcpy(state, start, sizeof(state));
+                std::memcpy(block, message, 32);
+                compress(state, block);
+                storeDigest(state, message);
+            }
+        }
+    };
+
+    //PBKDF2 with HMAC-SHA256, single 32-byte block of output
+    std::array<uint8_t, 32> pbkdf2(const std::string& password, const std::string& salt, const int iterations) {
+        std::string first = salt;
+        first += std::string("\0\0\0\1", 4);
+        auto u = PasswordHasher::hmacSha256(password, (const uint8_t*)first.data(), first.size());
+        auto result = u;
+        const HmacKey key(password);
+        for (int i = 1; i < iterations; i++) {
+            key.apply(u.data());
+            for (size_t j = 0; j < result.size(); j++) {
+                result[j] ^= u[j];
+            }
+        }
+        return result;
+    }
+
+    //compares 'a' and 'b' in time which does not depend on where they differ
+    bool constantTimeEquals(const std::string& a, const std::string& b) {
+        if (a.size() != b.size()) {
+            return false;
+        }
+        unsigned char diff = 0;
+        for (size_t i = 0; i < a.size(); i++) {
+            diff |= (unsigned char)(a[i] ^ b[i]);
+        }
+        return diff == 0;
+    }
+}
+
+PasswordHasher::PasswordHasher(const int iterations)
+    : iterations(iterations) {
+    if (iterations < 1) {
+        throw std::invalid_argument("Password hashing needs at least one iteration");
+    }
+}
+
+std::array<uint8_t, 32> PasswordHasher::sha256(const uint8_t* data, const size_t size) {
+    uint32_t state[8];
+    std::memcpy(state, INITIAL_STATE, sizeof(state));
+    size_t offset = 0;
+    for (; offset + 64 <= size; offset += 64) {
+        compress(state, data + offset);
+    }
+
+    uint8_t tail[128] = {};
+    const size_t rest = size - offset;
+    std::memcpy(tail, data + offset, rest);
+    tail[rest] = 0x80;
+    const size_t tailSize = rest < 56 ? 64 : 128;
+    const uint64_t bits = (uint64_t)size * 8;
+    for (int i = 0; i < 8; i++) {
+        tail[tailSize - 1 - i] = (uint8_t)(bits >> (i * 8));
+    }
+    compress(state, tail);
+    if (tailSize == 128) {
+        compress(state, tail + 64);
+    }
+
+    std::array<uint8_t, 32> digest{};
+    storeDigest(state, digest.data());
+    return digest;
+}
+
+std::array<uint8_t, 32> PasswordHasher::hmacSha256(const std::string& key, const uint8_t* data, const size_t size) {
+    uint8_t block[64] = {};
+    if (key.size() > 64) {
+        const auto hashed = sha256((const uint8_t*)key.data(), key.size());
+        std::memcpy(block, hashed.data(), hashed.size());
+    } else {
+        std::memcpy(block, key.data(), key.size());
+    }
+
+    std::string inner(64 + size, '\0');
+    std::string outer(64 + 32, '\0');
+    for (int i = 0; i < 64; i++) {
+        inner[i] = (char)(block[i] ^ 0x36);
+        outer[i] = (char)(block[i] ^ 0x5c);
+    }
+    std::memcpy(inner.data() + 64, data, size);
+    const auto innerHash = sha256((const uint8_t*)inner.data(), inner.size());
+    std::memcpy(outer.data() + 64, innerHash.data(), innerHash.size());
+    return sha256((const uint8_t*)outer.data(), outer.size());
+}
+
+//hashes 'password' with a fresh random salt
+std::string PasswordHasher::hash(const std::string& password) const {
+    thread_local std::random_device randomDevice;
+    std::string salt(SALT_SIZE, '\0');
+    for (auto& c : salt) {
+        c = (char)(randomDevice() & 0xFF);
+    }
+    const auto derived = pbkdf2(password, salt, iterations);
+    return PREFIX + std::to_string(iterations) + "$" + toHex((const uint8_t*)salt.data(), salt.size()) +
+           "$" + toHex(derived.data(), derived.size());
+}
+
+/**
+ * Checks 'password' against 'storedHash' made by 'hash()', using iterations count stored in the hash.
+ * Returns false for malformed hashes
+ */
+bool PasswordHasher::verify(const std::string& password, const std::string& storedHash) const {
+    if (!isHash(storedHash)) {
+        return false;
+    }
+    const size_t iterationsEnd = storedHash.find('$', PREFIX.size());
+    const size_t saltEnd = storedHash.find('$', iterationsEnd + 1);
+    if (iterationsEnd == std::string::npos || saltEnd == std::string::npos) {
+        return false;
+    }
+    try {
+        const int storedIterations = std::stoi(storedHash.substr(PREFIX.size(), iterationsEnd - PREFIX.size()));
+        const std::string salt = fromHex(storedHash.substr(iterationsEnd + 1, saltEnd - iterationsEnd - 1));
+        if (storedIterations < 1) {
+            return false;
+        }
+        const auto derived = pbkdf2(password, salt, storedIterations);
+        return constantTimeEquals(toHex(derived.data(), derived.size()), storedHash.substr(saltEnd + 1));
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+//returns true if 'storedHash' is not a hash at all or was made with a different iterations count
+bool PasswordHasher::needsRehash(const std::string& storedHash) const {
+    return !storedHash.starts_with(PREFIX + std::to_string(iterations) + "$");
+}
+
+//returns true if 'stored' looks like a hash made by this class (and not a legacy plain text password)
+bool PasswordHasher::isHash(const std::string& stored) {
+    return stored.starts_with(PREFIX);
+}
@@ -0,0 +1,73 @@
+#include "RateLimiter.h"
+
+#include <algorithm>
+#include <mutex>
+#include <utility>
+
+RateLimiter::RateLimiter(const int burst, const std::chrono::microseconds interval,
+                         const std::chrono::seconds idleTimeout, std::function<Clock::time_point()> clock)
+    : interval(std::chrono::duration_cast<std::chrono::nanoseconds>(interval).count()),
+      tolerance(std::chrono::duration_cast<std::chrono::nanoseconds>(interval).count() * (std::max(burst, 1) - 1)),
+      idleTimeout(std::chrono::duration_cast<std::chrono::nanoseconds>(idleTimeout).count()),
+      clock(std::move(clock)), start(this->clock()) {}
+
+//Nanoseconds since the limiter was created, so a fresh bucket (arrival 0) is always full
+int64_t RateLimiter::now() const {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(clock() - start).count() + tolerance + interval;
+}
+
+/**
+ * Takes one token from the bucket whose theoretical arrival time is 'arrival'.
+ * The bucket is empty when 'arrival' runs ahead of 'time' by more than 'tolerance'
+ */
+bool RateLimiter::take(std::atomic<int64_t>& arrival, const int64_t time) const {
+    int64_t current = arrival.load(std::memory_order_relaxed);
+    while (true) {
+        if (current - time > tolerance) {
+            return false;
+        }
+        if (arrival.compare_exchange_weak(current, std::max(current, time) + interval, std::memory_order_relaxed)) {
+            return true;
+        }
+    }
+}
+
+//Drops buckets of 'shard' which have been full for at least 'idleTimeout', expects exclusive lock of 'shard'
+void RateLimiter::sweep(Shard& shard, const int64_t time) const {
+    if (time < shard.nextSweep) {
+        return;
+    }
+    std::erase_if(shard.buckets, [&](const auto& bucket) {
+        return time - bucket.second.load(std::memory_order_relaxed) >= idleTimeout;
+    });
+    shard.nextSweep = time + idleTimeout;
+}
+
+/**
+ * Returns true and spends one token if 'key' is still within its limit, otherwise returns false.
+ */
+bool RateLimiter::tryAcquire(const std::string& key) {
+    auto& shard = shards[std::hash<std::string>{}(key) % SHARDS];
+    const int64_t time = now();
+    {
+        std::shared_lock lock(shard.mutex);
+        if (const auto it = shard.buckets.find(key); it != shard.buckets.end()) {
+            return take(it->second, time);
+        }
+    }
+
+    std::unique_lock lock(shard.mutex);
+    sweep(shard, time);
+    const auto it = shard.buckets.try_emplace(key, 0).first;
+    return take(it->second, time);
+}
+
+//Number of keys which currently have a bucket
+size_t RateLimiter::size() const {
+    size_t total = 0;
+    for (const auto& shard : shards) {
+        std::shared_lock lock(shard.mutex);
+        total += shard.buckets.size();
+    }
+    return total;
+}
@@ -5,8 +5,20 @@
 #include "HelperFunctions.h"
 #include <vector>
 
-ServerAuthenticator::ServerAuthenticator(std::shared_ptr<AuthHandler> authHandler)
-    : authHandler(std::move(authHandler)) {}
+namespace {
+    bool withinLimit(const std::shared_ptr<RateLimiter>& limiter, const std::string& key) {
+        return !limiter || limiter->tryAcquire(key);
+    }
+}
+
+ServerAuthenticator::ServerAuthenticator(std::shared_ptr<AuthHandler> authHandler,
+                                         std::shared_ptr<SessionManager> sessionManager,
+                                         std::shared_ptr<RateLimiter> addressLimiter,
+                                         std::shared_ptr<RateLimiter> accountLimiter,
+                                         std::shared_ptr<UsernameTable> usernames)
+    : authHandler(std::move(authHandler)), sessionManager(std::move(sessionManager)),
+      addressLimiter(std::move(addressLimiter)), accountLimiter(std::move(accountLimiter)),
+      usernames(std::move(usernames)) {}
 
 /**
  * Using 'promptUser()', makes a registration dialogue between server and client.
@@ -20,72 +32,143 @@ bool ServerAuthenticator::handleRegistration(const SOCKET clientSocket) {
         return false;
     }
 
-    std::lock_guard<std::mutex> lock(authMutex);
-    const std::string output = authHandler->registerUser(
-        userInput[0], userInput[1], userInput[2]);
-    sendToClient(clientSocket, output);
-
+    sendToClient(clientSocket, registerUser(userInput[0], userInput[1], userInput[2]));
     return true;
 }
 
+//Registers a new user through authHandler and returns the message for the client
+std::string ServerAuthenticator::registerUser(const std::string& username, const std::string& password,
+                                              const std::string& repeatedPassword) const {
+    return authHandler->registerUser(username, password, repeatedPassword);
+}
+
+//Charges one REG/LOG/RESUME to 'clientAddress', returns false once the address ran out of attempts
+bool ServerAuthenticator::allowAttempt(const std::string& clientAddress) const {
+    return withinLimit(addressLimiter, clientAddress);
+}
+
 /**
  * Using 'promptUser()', makes a login dialogue between server and client.
- * If user disconnected returns '~' as the username
- * Otherwise, if user logged in successfully, returns real username
- * Else, returns empty string, meaning a 'default' username
- * Uses authHandler to send corresponding message to the client
+ * If user disconnected returns empty handle with id -1
+ * Otherwise, if user logged in successfully, inserts handle of the username into 'activeUsers' and returns it with id of the user
+ * Else, returns empty handle, meaning a 'default' username
+ * Uses authHandler to send corresponding message to the client, nothing is sent while a lock is held
+ * On success the message is followed by a session token for future reconnects
  */
-std::string ServerAuthenticator::handleLogin(const SOCKET clientSocket,
-                std::mutex& activeUsersMutex, const std::unordered_set<std::string> &activeUsers) {
+std::pair<Username, int> ServerAuthenticator::handleLogin(const SOCKET clientSocket,
+                std::mutex& activeUsersMutex, std::unordered_set<Username> &activeUsers) {
     std::vector<std::string> userInput = promptUser(clientSocket,
         {"Enter username: ", "Enter password: "});
     if (userInput.empty()) {
-        return "~";
+        return {{}, -1};
     }
 
-    std::lock_guard<std::mutex> lock(authMutex);
-    std::string output = authHandler->loginUser(userInput[0], userInput[1]);
+    const LoginResult result = login(userInput[0], userInput[1], activeUsersMutex, activeUsers);
+    sendToClient(clientSocket, result.token.empty() ? result.message
+                                                    : result.message + "\nSession token: " + result.token + "\n");
+    return {result.username, result.userId};
+}
 
-    if (output.find("logged in successfully") != std::string::npos) {
-        std::lock_guard<std::mutex> lock2(activeUsersMutex);
-        if (activeUsers.contains(userInput[0])) {
-            output = "You are already logged in.";
-        } else {
-            sendToClient(clientSocket, output);
-            return userInput[0];
-        }
+/**
+ * Checks 'username' and 'password' and claims the username in 'activeUsers', nothing is sent to the client.
+ * 'username' only went through 'sanitizeInput', the username rules apply to registration alone
+ * Accounts which exceeded their attempts are refused before the password is looked at
+ */
+ServerAuthenticator::LoginResult ServerAuthenticator::login(const std::string& username, const std::string& password,
+                std::mutex& activeUsersMutex, std::unordered_set<Username>& activeUsers) const {
+    if (!withinLimit(accountLimiter, username)) {
+        return {{}, 0, RATE_LIMITED_MESSAGE};
+    }
+
+    auto [output, userId] = authHandler->loginUser(username, password);
+    if (userId == 0) {
+        return {{}, 0, output};
     }
 
-    sendToClient(clientSocket, output);
-    return "";
+    const Username handle = usernames->intern(username);
+    bool claimed;
+    {
+        std::lock_guard<std::mutex> lock(activeUsersMutex);
+        claimed = activeUsers.insert(handle).second;
+    }
+    if (!claimed) {
+        return {{}, 0, "You are already logged in."};
+    }
+    return {handle, userId, output, sessionManager->issue(userId)};
+}
+
+/**
+ * Logs the client in using session 'token' issued by an earlier login, without checking the password.
+ * Returns username handle and id of the user on success, otherwise empty handle, meaning a 'default' username
+ */
+std::pair<Username, int> ServerAuthenticator::handleResume(const SOCKET clientSocket, const std::string& token,
+                std::mutex& activeUsersMutex, std::unordered_set<Username>& activeUsers) {
+    const LoginResult result = resume(token, activeUsersMutex, activeUsers);
+    sendToClient(clientSocket, result.message);
+    return {result.username, result.userId};
+}
+
+/**
+ * Verifies session 'token' and claims the username of its user in 'activeUsers', nothing is sent to the client.
+ * The token only carries the user id, the username is looked up by it
+ */
+ServerAuthenticator::LoginResult ServerAuthenticator::resume(const std::string& token,
+                std::mutex& activeUsersMutex, std::unordered_set<Username>& activeUsers) const {
+    const int userId = sessionManager->verify(token);
+    const std::string name = userId == 0 ? "" : authHandler->usernameOf(userId);
+    if (name.empty()) {
+        return {{}, 0, "Session token is invalid or expired.\n"};
+    }
+    const Username username = usernames->intern(name);
+
+    bool claimed;
+    {
+        std::lock_guard<std::mutex> lock(activeUsersMutex);
+        claimed = activeUsers.insert(username).second;
+    }
+    if (!claimed) {
+        return {{}, 0, "You are already logged in.\n"};
+    }
+    return {username, userId, "Session of " + username.str() + " resumed\n"};
 }
 
 /**
  * Asks client to choose between logging in, registration or exiting the application.
- * Depending on scenario, starts corresponding dialogue
+ * Depending on scenario, starts corresponding dialogue, "RESUME <token>" skips the dialogue altogether
+ * Each REG/LOG/RESUME is charged to 'clientAddress', once it runs out of attempts they are refused right away
  * Unless user disconnects, choose to exit or logs in successfully, this function runs in infinite loop
  *
- * Once the loop ends, if client logged in successfully, returns username of the user
- * Otherwise, returns empty string, meaning a 'default' username
+ * Once the loop ends, if client logged in successfully, returns username handle and id of the user
+ * Otherwise, returns empty handle, meaning a 'default' username
  */
-std::string ServerAuthenticator::loginRegistrationPhase(const SOCKET clientSocket,
-                                std::mutex& activeUsersMutex, const std::unordered_set<std::string>& activeUsers) {
+std::pair<Username, int> ServerAuthenticator::loginRegistrationPhase(const SOCKET clientSocket,
+                                const std::string& clientAddress,
+                                std::mutex& activeUsersMutex, std::unordered_set<Username>& activeUsers) {
     while (true) {
         std::vector<std::string> userInput = promptUser(clientSocket, {"Enter command (REG/LOG/EXIT): "});
         if (userInput.empty()) {
             break;
         }
-        if (const std::string& command = userInput[0]; command == "REG") {
+        const std::string& command = userInput[0];
+        if ((command == "REG" || command == "LOG" || command.starts_with("RESUME ")) &&
+            !allowAttempt(clientAddress)) {
+            sendToClient(clientSocket, RATE_LIMITED_MESSAGE);
+        } else if (command == "REG") {
             if (!handleRegistration(clientSocket)) {
                 break;
             }
         } else if (command == "LOG") {
-            std::string username = handleLogin(clientSocket, activeUsersMutex, activeUsers);
-            if (username == "~") {
+            auto login = handleLogin(clientSocket, activeUsersMutex, activeUsers);
+            if (login.second < 0) {
                 break;
             }
-            if (!username.empty()) {
-                return username;
+            if (!login.first.empty()) {
+                return login;
+            }
+        } else if (command.starts_with("RESUME ")) {
+            auto session = handleResume(clientSocket, command.substr(7), activeUsersMutex, activeUsers);
+            if (!session.first.empty()) {
+                return session;
             }
         } else if (command == "EXIT") {
             const auto goodbye_message = "Goodbye!";
@@ -98,5 +181,5 @@ std::string ServerAuthenticator::loginRegistrationPhase(const SOCKET clientSocke
         }
     }
 
-    return "";
+    return {{}, 0};
 }
@@ -0,0 +1,80 @@
+#include "SessionManager.h"
+#include "PasswordHasher.h"
+
+#include <random>
+
+namespace {
+    long long now() {
+        return std::chrono::duration_cast<std::chrono::seconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+}
+
+SessionManager::SessionManager(std::string secret, const std::chrono::seconds lifetime)
+    : secret(std::move(secret)), lifetime(lifetime) {}
+
+std::string SessionManager::sign(const std::string& payload) const {
+    constexpr char digits[] = "0123456789abcdef";
+    const auto mac = PasswordHasher::hmacSha256(secret, (const uint8_t*)payload.data(), payload.size());
+    std::string hex;
+    for (const auto byte : mac) {
+        hex += digits[byte >> 4];
+        hex += digits[byte & 15];
+    }
+    return hex;
+}
+
+//makes a token for the user with id 'userId' which is valid for 'lifetime' from now
+std::string SessionManager::issue(const int userId) const {
+    const std::string payload = std::to_string(userId) + "." + std::to_string(now() + lifetime.count());
+    return payload + "." + sign(payload);
+}
+
+/**
+ * Checks signature and expiry of 'token'.
+ * Returns id of the user the token was issued for, or 0 if the token is invalid
+ */
+int SessionManager::verify(const std::string& token) const {
+    const size_t idEnd = token.find('.');
+    const size_t expiryEnd = token.find('.', idEnd == std::string::npos ? idEnd : idEnd + 1);
+    if (expiryEnd == std::string::npos) {
+        return 0;
+    }
+
+    const std::string payload = token.substr(0, expiryEnd);
+    const std::string signature = token.substr(expiryEnd + 1);
+    const std::string expected = sign(payload);
+    if (signature.size() != expected.size()) {
+        return 0;
+    }
+    unsigned char diff = 0;
+    for (size_t i = 0; i < expected.size(); i++) {
+        diff |= (unsigned char)(signature[i] ^ expected[i]);
+    }
+    if (diff != 0) {
+        return 0;
+    }
+
+    try {
+        const int userId = std::stoi(token.substr(0, idEnd));
+        if (std::stoll(token.substr(idEnd + 1, expiryEnd - idEnd - 1)) < now()) {
+            return 0;
+        }
+        return userId;
+    } catch (const std::exception&) {
+        return 0;
+    }
+}
+
+//returns 32 random bytes as hex, used as 'secret' when none was configured
+std::string SessionManager::randomSecret() {
+    constexpr char digits[] = "0123456789abcdef";
+    std::random_device randomDevice;
+    std::string secret;
+    for (int i = 0; i < 32; i++) {
+        const unsigned byte = randomDevice() & 0xFF;
+        secret += digits[byte >> 4];
+        secret += digits[byte & 15];
+    }
+    return secret;
+}
@@ -0,0 +1,99 @@
+#include "SqliteUserDao.h"
+#include <stdexcept>
+#include <iostream>
+
+/**
+ * Makes sure 'Users' table is keyed on an integer 'Id'.
+ * Databases created before integer ids existed (keyed on 'Username') are migrated in place,
+ * users keep their usernames and passwords and get ids in insertion order.
+ */
+SqliteUserDAO::SqliteUserDAO(std::shared_ptr<Database> database)
+    : database(std::move(database))
+{
+    auto connection = this->database->writer();
+    if (connection.hasColumn("Users", "Username") && !connection.hasColumn("Users", "Id")) {
+        connection.execTransaction("ALTER TABLE Users RENAME TO UsersLegacy;"
+                                   "CREATE TABLE Users ("
+                                   "Id INTEGER PRIMARY KEY AUTOINCREMENT, "
+                                   "Username TEXT NOT NULL UNIQUE, "
+                                   "Password TEXT NOT NULL);"
+                                   "INSERT INTO Users (Username, Password) "
+                                   "SELECT Username, Password FROM UsersLegacy ORDER BY rowid;"
+                                   "DROP TABLE UsersLegacy;", "Users migration: ");
+    }
+
+    const std::string createTableSQL = "CREATE TABLE IF NOT EXISTS Users ("
+                                        "Id INTEGER PRIMARY KEY AUTOINCREMENT, "
+                                        "Username TEXT NOT NULL UNIQUE, "
+                                        "Password TEXT NOT NULL);";
+    connection.exec(createTableSQL, "Users: ");
+}
+
+/**
+ *Takes a 'username' as an argument and returns User object which contains the id and password stored in database.
+ *If the 'username' does not appear in database, returns 'default' User object
+*/
+User SqliteUserDAO::getUserByName(const std::string& username) const {
+    auto connection = database->reader();
+    sqlite3_stmt* stmt = connection.prepare("SELECT Id, Password FROM Users WHERE Username = ?");
+    sqlite3_bind_text(stmt, 1, username.c_str(), -1, SQLITE_STATIC);
+
+    User user("", "");
+    if (connection.step(stmt) == SQLITE_ROW) {
+        const int id = sqlite3_column_int(stmt, 0);
+        const std::string password = (const char*)(sqlite3_column_text(stmt, 1));
+        user = User(username, password, id);
+    }
+    return user;
+}
+
+//Same as 'getUserByName' but looks the user up by its integer 'id'
+User SqliteUserDAO::getUserById(const int id) const {
+    auto connection = database->reader();
+    sqlite3_stmt* stmt = connection.prepare("SELECT Username, Password FROM Users WHERE Id = ?");
+    sqlite3_bind_int(stmt, 1, id);
+
+    User user("", "");
+    if (connection.step(stmt) == SQLITE_ROW) {
+        const std::string username = (const char*)(sqlite3_column_text(stmt, 0));
+        const std::string password = (const char*)(sqlite3_column_text(stmt, 1));
+        user = User(username, password, id);
+    }
+    return user;
+}
+
+/**
+ * Adds user with unique username in the database and returns the id assigned to it.
+ * Returns 0 if UNIQUE constraint on 'Username' rejected the user
+ */
+int SqliteUserDAO::addUser(const User& user) const {
+    auto connection = database->writer();
+    sqlite3_stmt* stmt = connection.prepare("INSERT INTO Users (Username, Password) VALUES (?, ?);");
+    const std::string username = user.getUsername();
+    const std::string password = user.getPassword();
+    sqlite3_bind_text(stmt, 1, username.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 2, password.c_str(), -1, SQLITE_STATIC);
+
+    if (const int result = connection.step(stmt); result == SQLITE_CONSTRAINT) {
+        return 0;
+    } else if (result != SQLITE_DONE) {
+        std::string error = "Failed to add user: ";
+        error += sqlite3_errmsg(connection.get());
+        throw std::runtime_error(error);
+    }
+    return (int)sqlite3_last_insert_rowid(connection.get());
+}
+
+//Replaces stored password of the user with id 'id'
+void SqliteUserDAO::updatePassword(const int id, const std::string& password) const {
+    auto connection = database->writer();
+    sqlite3_stmt* stmt = connection.prepare("UPDATE Users SET Password = ? WHERE Id = ?;");
+    sqlite3_bind_text(stmt, 1, password.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_int(stmt, 2, id);
+
+    if (connection.step(stmt) != SQLITE_DONE) {
+        std::string error = "Failed to update password: ";
+        error += sqlite3_errmsg(connection.get());
+        throw std::runtime_error(error);
+    }
+}
@@ -1,13 +1,17 @@
 #include "User.h"
 
-User::User(std::string username, std::string password)
-    : username(std::move(username)), password(std::move(password)) {}
+User::User(std::string username, std::string password, const int id)
+    : id(id), username(std::move(username)), password(std::move(password)) {}
 
 //checks if all the fields of User 'this' match the fields of User 'other'
 bool User::equals(const User &other) const {
     return username == other.username && password == other.password;
 }
 
+int User::getId() const {
+    return id;
+}
+
 std::string User::getUsername() const {
     return username;
 }
@@ -0,0 +1,49 @@
+#include "UsernameTable.h"
+
+#include <mutex>
+
+//Username is 'MIN_LENGTH' to 'MAX_LENGTH' characters long and contains only letters, digits, '_', '-' and '.'
+bool UsernameTable::isValid(const std::string_view username) {
+    if (username.size() < MIN_LENGTH || username.size() > MAX_LENGTH) {
+        return false;
+    }
+    for (const char c : username) {
+        const bool allowed = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') ||
+                             c == '_' || c == '-' || c == '.';
+        if (!allowed) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Returns handle of the single stored copy of 'username', storing it under a new id first if it is not in the table yet
+ */
+Username UsernameTable::intern(const std::string_view username) {
+    const std::string key(username);
+    auto& shard = shards[std::hash<std::string>{}(key) % SHARDS];
+    {
+        std::shared_lock lock(shard.mutex);
+        if (const auto it = shard.names.find(key); it != shard.names.end()) {
+            return {it->second, &it->first};
+        }
+    }
+
+    std::unique_lock lock(shard.mutex);
+    const auto it = shard.names.try_emplace(key, 0).first;
+    if (it->second == 0) {
+        it->second = nextId++;
+    }
+    return {it->second, &it->first};
+}
+
+//Number of distinct usernames interned so far
+size_t UsernameTable::size() const {
+    size_t total = 0;
+    for (const auto& shard : shards) {
+        std::shared_lock lock(shard.mutex);
+        total += shard.names.size();
+    }
+    return total;
+}
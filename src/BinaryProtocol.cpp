@@ -0,0 +1,163 @@
+#include "BinaryProtocol.h"
+
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+
+namespace {
+    //Waits at most 'wait' until 'socket' has something to read, returns false if it did not get anything
+    bool waitReadable(const SOCKET socket, const std::chrono::microseconds wait) {
+        fd_set readable;
+        FD_ZERO(&readable);
+        FD_SET(socket, &readable);
+        timeval timeout = {(long)(wait.count() / 1000000), (long)(wait.count() % 1000000)};
+        return select((int)socket + 1, &readable, nullptr, nullptr, &timeout) > 0;
+    }
+}
+
+/**
+ * Tells a binary client from a text one by the first byte of a new connection: only 'BINARY_HELLO' starts with NUL.
+ * A text client waits for the first prompt and sends nothing, so the first byte is only waited for 'firstByteWait',
+ * which covers a hello sent right after connecting that is still on its way when the connection is accepted.
+ * Once the first byte is NUL the rest of the hello is read within 'helloWait'.
+ * Returns the protocol version the client asked for, 0 (no such version) if the hello was cut short or is not
+ * 'BINARY_HELLO', or std::nullopt for a text client, whose bytes are left for the dialogue
+ */
+std::optional<uint8_t> negotiateBinary(const SOCKET clientSocket, const std::chrono::milliseconds firstByteWait,
+                                       const std::chrono::milliseconds helloWait) {
+    char hello[BINARY_HELLO.size() + 1];
+    if (!waitReadable(clientSocket, firstByteWait) ||
+        recv(clientSocket, hello, 1, MSG_PEEK) != 1 || hello[0] != BINARY_HELLO[0]) {
+        return std::nullopt;
+    }
+
+    const auto deadline = std::chrono::steady_clock::now() + helloWait;
+    size_t received = 0;
+    while (received < sizeof(hello)) {
+        const auto left = std::chrono::duration_cast<std::chrono::microseconds>(deadline - std::chrono::steady_clock::now());
+        if (left.count() <= 0 || !waitReadable(clientSocket, left)) {
+            return 0;
+        }
+        const int read = recv(clientSocket, hello + received, (int)(sizeof(hello) - received), 0);
+        if (read <= 0) {
+            return 0;
+        }
+        received += read;
+    }
+    return std::equal(BINARY_HELLO.begin(), BINARY_HELLO.end(), hello) ? (uint8_t)hello[BINARY_HELLO.size()] : 0;
+}
+
+//Starts a new frame of 'type', the previous one is forgotten but its memory is kept
+FrameWriter& FrameWriter::begin(const FrameType type) {
+    buffer.clear();
+    buffer.push_back((char)type);
+    buffer.append(2, '\0');
+    return *this;
+}
+
+FrameWriter& FrameWriter::put8(const uint8_t value) {
+    buffer.push_back((char)value);
+    return *this;
+}
+
+FrameWriter& FrameWriter::put16(const uint16_t value) {
+    buffer.push_back((char)(value >> 8));
+    buffer.push_back((char)value);
+    return *this;
+}
+
+FrameWriter& FrameWriter::put32(const uint32_t value) {
+    put16((uint16_t)(value >> 16));
+    return put16((uint16_t)value);
+}
+
+FrameWriter& FrameWriter::putDouble(const double value) {
+    const auto bits = std::bit_cast<uint64_t>(value);
+    put32((uint32_t)(bits >> 32));
+    return put32((uint32_t)bits);
+}
+
+FrameWriter& FrameWriter::putString(const std::string_view value) {
+    const size_t size = std::min<size_t>(value.size(), 255);
+    put8((uint8_t)size);
+    buffer.append(value.data(), size);
+    return *this;
+}
+
+//Fills in the payload length and posts the whole frame at once, returns false if it was dropped
+bool FrameWriter::sendTo(Outbox& outbox) {
+    const size_t payload = buffer.size() - FRAME_HEADER_SIZE;
+    buffer[1] = (char)(payload >> 8);
+    buffer[2] = (char)payload;
+    return outbox.post(buffer);
+}
+
+FrameReader::FrameReader(const FrameType type, const std::string_view payload) : type(type), payload(payload) {}
+
+FrameType FrameReader::getType() const {
+    return type;
+}
+
+std::string_view FrameReader::take(const size_t size) {
+    if (payload.size() < size) {
+        throw std::runtime_error("Frame " + std::to_string((int)type) + " is shorter than its type needs");
+    }
+    const std::string_view taken = payload.substr(0, size);
+    payload.remove_prefix(size);
+    return taken;
+}
+
+uint8_t FrameReader::get8() {
+    return (uint8_t)take(1)[0];
+}
+
+uint16_t FrameReader::get16() {
+    const std::string_view bytes = take(2);
+    return (uint16_t)((uint8_t)bytes[0] << 8 | (uint8_t)bytes[1]);
+}
+
+uint32_t FrameReader::get32() {
+    const uint32_t high = get16();
+    return high << 16 | get16();
+}
+
+std::string FrameReader::getString() {
+    const size_t size = get8();
+    return std::string(take(size));
+}
+
+//Appends received bytes, frames already taken are dropped first so the buffer does not grow with the connection
+void FrameReceiver::feed(const std::string_view bytes) {
+    buffer.erase(0, start);
+    start = 0;
+    buffer.append(bytes);
+}
+
+//Payload length of the frame at 'start', whose header has arrived
+size_t FrameReceiver::payloadLength() const {
+    const size_t length = (size_t)(uint8_t)buffer[start + 1] << 8 | (uint8_t)buffer[start + 2];
+    if (length > MAX_FRAME_PAYLOAD) {
+        throw std::runtime_error("Frame of " + std::to_string(length) + " bytes is too long");
+    }
+    return length;
+}
+
+//Type of the next complete frame without taking it, std::nullopt while its bytes have not all arrived yet
+std::optional<FrameType> FrameReceiver::peek() const {
+    if (buffer.size() - start < FRAME_HEADER_SIZE ||
+        buffer.size() - start < FRAME_HEADER_SIZE + payloadLength()) {
+        return std::nullopt;
+    }
+    return (FrameType)buffer[start];
+}
+
+//The next complete frame, std::nullopt while its bytes have not all arrived yet
+std::optional<FrameReader> FrameReceiver::next() {
+    if (!peek()) {
+        return std::nullopt;
+    }
+    const size_t length = payloadLength();
+    FrameReader frame((FrameType)buffer[start], std::string_view(buffer).substr(start + FRAME_HEADER_SIZE, length));
+    start += FRAME_HEADER_SIZE + length;
+    return frame;
+}
@@ -0,0 +1,12 @@
+#include "BlocklistChecker.h"
+
+//checks whether password is absent from the blocklist, after all checks of the rest of the chain passed
+std::string BlocklistChecker::check(const std::string& password) const {
+    if (std::string error = PasswordChecker::check(password); !error.empty()) {
+        return error;
+    }
+    if (filter->mayContain(password)) {
+        return "Password is too common, choose a different one.";
+    }
+    return "";
+}
@@ -0,0 +1,138 @@
+#include "BlocklistFilter.h"
+
+#include <windows.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+static_assert(sizeof(BlocklistFilter::Header) == BlocklistFilter::BLOCK_BYTES);
+
+namespace {
+    //Final mix of MurmurHash3, spreads every input bit over the whole word
+    uint64_t mix(uint64_t value) {
+        value ^= value >> 33;
+        value *= 0xff51afd7ed558ccdULL;
+        value ^= value >> 33;
+        value *= 0xc4ceb9fe1a85ec53ULL;
+        value ^= value >> 33;
+        return value;
+    }
+
+    //Bit positions inside a block are taken 9 bits (one of 512) at a time from a second, independent hash
+    constexpr uint32_t BIT_INDEX_BITS = 9;
+    constexpr uint32_t MAX_HASHES = 64 / BIT_INDEX_BITS;
+}
+
+//FNV-1a of 'password' passed through 'mix'
+uint64_t BlocklistFilter::hash(const std::string_view password) {
+    uint64_t value = 0xcbf29ce484222325ULL;
+    for (const char c : password) {
+        value ^= (unsigned char)c;
+        value *= 0x100000001b3ULL;
+    }
+    return mix(value);
+}
+
+bool BlocklistFilter::test(const uint8_t* block, const uint64_t hash, const uint32_t hashCount) {
+    uint64_t bits = mix(hash ^ 0x9e3779b97f4a7c15ULL);
+    for (uint32_t i = 0; i < hashCount; i++, bits >>= BIT_INDEX_BITS) {
+        const uint32_t bit = bits & (BLOCK_BYTES * 8 - 1);
+        if ((block[bit / 8] & (1 << (bit % 8))) == 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void BlocklistFilter::set(uint8_t* block, const uint64_t hash, const uint32_t hashCount) {
+    uint64_t bits = mix(hash ^ 0x9e3779b97f4a7c15ULL);
+    for (uint32_t i = 0; i < hashCount; i++, bits >>= BIT_INDEX_BITS) {
+        const uint32_t bit = bits & (BLOCK_BYTES * 8 - 1);
+        block[bit / 8] |= (uint8_t)(1 << (bit % 8));
+    }
+}
+
+//Maps the whole file at 'path' read-only and validates its header
+BlocklistFilter::BlocklistFilter(const std::string& path) : file(nullptr), mapping(nullptr), view(nullptr), header() {
+    file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                       FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error("Failed to open blocklist " + path);
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || (uint64_t)size.QuadPart < sizeof(Header)) {
+        CloseHandle(file);
+        throw std::runtime_error("Blocklist " + path + " is too small");
+    }
+
+    mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping) {
+        view = (const uint8_t*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    }
+    if (!view) {
+        if (mapping) {
+            CloseHandle(mapping);
+        }
+        CloseHandle(file);
+        throw std::runtime_error("Failed to map blocklist " + path);
+    }
+
+    std::memcpy(&header, view, sizeof(Header));
+    const uint64_t expectedSize = sizeof(Header) + header.blockCount * BLOCK_BYTES;
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.blockCount == 0 ||
+        header.hashCount == 0 || header.hashCount > MAX_HASHES || (uint64_t)size.QuadPart != expectedSize) {
+        UnmapViewOfFile(view);
+        CloseHandle(mapping);
+        CloseHandle(file);
+        throw std::runtime_error("Blocklist " + path + " is not a valid blocklist filter");
+    }
+}
+
+BlocklistFilter::~BlocklistFilter() {
+    UnmapViewOfFile(view);
+    CloseHandle(mapping);
+    CloseHandle(file);
+}
+
+//Returns false if 'password' is certainly not in the blocklist, true if it (most likely) is
+bool BlocklistFilter::mayContain(const std::string_view password) const {
+    const uint64_t value = hash(password);
+    const uint8_t* block = view + sizeof(Header) + (value % header.blockCount) * BLOCK_BYTES;
+    return test(block, value, header.hashCount);
+}
+
+uint64_t BlocklistFilter::getEntryCount() const {
+    return header.entryCount;
+}
+
+/**
+ * Allocates enough blocks for 'expectedEntries' at 'bitsPerEntry' bits each and picks the number of
+ * bits set per entry which gives the fewest false positives for that size
+ */
+BlocklistFilterBuilder::BlocklistFilterBuilder(const uint64_t expectedEntries, const double bitsPerEntry) : header() {
+    const double totalBits = std::max(1.0, (double)expectedEntries * bitsPerEntry);
+    std::memcpy(header.magic, BlocklistFilter::MAGIC, sizeof(header.magic));
+    header.blockCount = std::max<uint64_t>(1, (uint64_t)std::ceil(totalBits / (BlocklistFilter::BLOCK_BYTES * 8)));
+    header.hashCount = (uint32_t)std::clamp(std::lround(bitsPerEntry * std::log(2.0)), 1L, (long)MAX_HASHES);
+    blocks.assign(header.blockCount * BlocklistFilter::BLOCK_BYTES, 0);
+}
+
+void BlocklistFilterBuilder::add(const std::string_view password) {
+    const uint64_t value = BlocklistFilter::hash(password);
+    uint8_t* block = blocks.data() + (value % header.blockCount) * BlocklistFilter::BLOCK_BYTES;
+    BlocklistFilter::set(block, value, header.hashCount);
+    header.entryCount++;
+}
+
+//Writes header and blocks to 'path', throws std::runtime_error on failure
+void BlocklistFilterBuilder::save(const std::string& path) const {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write((const char*)&header, sizeof(header));
+    out.write((const char*)blocks.data(), (std::streamsize)blocks.size());
+    if (!out) {
+        throw std::runtime_error("Failed to write blocklist " + path);
+    }
+}
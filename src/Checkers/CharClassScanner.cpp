@@ -0,0 +1,46 @@
+#include "CharClassScanner.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CHAR_CLASS_SSE2
+#include <emmintrin.h>
+#endif
+
+#ifdef CHAR_CLASS_SSE2
+namespace {
+    //Lanes of 'bytes' which lie in [low, high], signed compares are fine because non-ASCII bytes are negative
+    __m128i inRange(const __m128i bytes, const char low, const char high) {
+        return _mm_and_si128(_mm_cmpgt_epi8(bytes, _mm_set1_epi8((char)(low - 1))),
+                             _mm_cmplt_epi8(bytes, _mm_set1_epi8((char)(high + 1))));
+    }
+}
+#endif
+
+uint8_t scanCharClasses(const std::string_view text) {
+    size_t i = 0;
+    uint8_t classes = 0;
+#ifdef CHAR_CLASS_SSE2
+    __m128i lower = _mm_setzero_si128();
+    __m128i upper = _mm_setzero_si128();
+    __m128i digit = _mm_setzero_si128();
+    __m128i symbol = _mm_setzero_si128();
+    __m128i nonAscii = _mm_setzero_si128();
+    for (; i + 16 <= text.size(); i += 16) {
+        const __m128i bytes = _mm_loadu_si128((const __m128i*)(text.data() + i));
+        const __m128i isLower = inRange(bytes, 'a', 'z');
+        const __m128i isUpper = inRange(bytes, 'A', 'Z');
+        const __m128i isDigit = inRange(bytes, '0', '9');
+        const __m128i isPrintable = inRange(bytes, '!', '~');
+        lower = _mm_or_si128(lower, isLower);
+        upper = _mm_or_si128(upper, isUpper);
+        digit = _mm_or_si128(digit, isDigit);
+        symbol = _mm_or_si128(symbol, _mm_andnot_si128(_mm_or_si128(_mm_or_si128(isLower, isUpper), isDigit), isPrintable));
+        nonAscii = _mm_or_si128(nonAscii, bytes);
+    }
+    if (_mm_movemask_epi8(lower)) classes |= (uint8_t)CharClass::LOWER;
+    if (_mm_movemask_epi8(upper)) classes |= (uint8_t)CharClass::UPPER;
+    if (_mm_movemask_epi8(digit)) classes |= (uint8_t)CharClass::DIGIT;
+    if (_mm_movemask_epi8(symbol)) classes |= (uint8_t)CharClass::SYMBOL;
+    if (_mm_movemask_epi8(nonAscii)) classes |= (uint8_t)CharClass::NON_ASCII;
+#endif
+    return classes | scanCharClassesScalar(text.substr(i));
+}
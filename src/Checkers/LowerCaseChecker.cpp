@@ -1,9 +1,9 @@
 #include "LowerCaseChecker.h"
-#include <algorithm>
+#include "CharClassScanner.h"
 
 //checks whether password contains at least one lower case letter
 std::string LowerCaseChecker::check(const std::string& password) const {
-    if (!std::ranges::any_of(password, ::islower)) {
+    if (!hasCharClass(scanCharClasses(password), CharClass::LOWER)) {
         return "Password must contain lower-case letter.";
     }
     return PasswordChecker::check(password);
@@ -0,0 +1,68 @@
+#include "RuntimePasswordPolicy.h"
+
+#include <bit>
+#include <charconv>
+#include <sstream>
+#include <stdexcept>
+#include "HelperFunctions.h"
+
+namespace {
+    //Value of "key=value" 'rule', which must be a whole number within 'min'..'max'
+    int valueOf(const std::string& rule, const int min, const int max) {
+        const std::string_view value = std::string_view(rule).substr(rule.find('=') + 1);
+        int number = 0;
+        const auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), number);
+        if (error != std::errc() || end != value.data() + value.size() || number < min || number > max) {
+            throw std::invalid_argument("Password rule " + rule + " needs a number within " +
+                                        std::to_string(min) + "-" + std::to_string(max));
+        }
+        return number;
+    }
+}
+
+/**
+ * Parses 'spec' into the list of rules.
+ * Throws std::invalid_argument if a rule is unknown, the length is not within 1-MAX_INPUT_LENGTH
+ * (no longer password gets through sanitizeInput) or the number of classes is not within 0-4
+ */
+RuntimePasswordPolicy::RuntimePasswordPolicy(const std::string& spec) {
+    std::stringstream stream(spec);
+    std::string rule;
+    while (std::getline(stream, rule, ',')) {
+        if (rule.starts_with("length=")) {
+            const size_t minLength = valueOf(rule, 1, (int)MAX_INPUT_LENGTH);
+            rules.push_back({minLength, 0, 0,
+                "Password must be at least " + std::to_string(minLength) + " characters long."});
+        } else if (rule == "upper") {
+            rules.push_back({0, (uint8_t)CharClass::UPPER, 0, std::string(RequireUpperCase::check({}))});
+        } else if (rule == "lower") {
+            rules.push_back({0, (uint8_t)CharClass::LOWER, 0, std::string(RequireLowerCase::check({}))});
+        } else if (rule == "digit") {
+            rules.push_back({0, (uint8_t)CharClass::DIGIT, 0, std::string(RequireDigit::check({}))});
+        } else if (rule == "symbol") {
+            rules.push_back({0, (uint8_t)CharClass::SYMBOL, 0, std::string(RequireSymbol::check({}))});
+        } else if (rule.starts_with("classes=")) {
+            const int minClasses = valueOf(rule, 0, 4);
+            rules.push_back({0, 0, minClasses, "Password must contain at least " + std::to_string(minClasses) +
+                " of: lower-case letter, upper-case letter, digit, symbol."});
+        } else if (!rule.empty()) {
+            throw std::invalid_argument("Unknown password rule: " + rule);
+        }
+    }
+}
+
+//Returns message of the first rule 'password' breaks, or empty string_view if it satisfies all of them
+std::string_view RuntimePasswordPolicy::verdict(const std::string_view password) const {
+    const PasswordStats stats = PasswordStats::of(password);
+    for (const auto& rule : rules) {
+        if (stats.length < rule.minLength || (stats.classes & rule.classes) != rule.classes ||
+            std::popcount((unsigned)(stats.classes & 15)) < rule.minClasses) {
+            return rule.message;
+        }
+    }
+    return {};
+}
+
+std::string RuntimePasswordPolicy::check(const std::string& password) const {
+    return std::string(verdict(password));
+}
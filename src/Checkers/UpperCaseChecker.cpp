@@ -1,9 +1,9 @@
 #include "UpperCaseChecker.h"
-#include <algorithm>
+#include "CharClassScanner.h"
 
 //checks whether password contains at least one upper case letter
 std::string UpperCaseChecker::check(const std::string& password) const {
-    if (!std::ranges::any_of(password, ::isupper)) {
+    if (!hasCharClass(scanCharClasses(password), CharClass::UPPER)) {
         return "Password must contain upper-case letter.";
     }
     return PasswordChecker::check(password);
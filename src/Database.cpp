@@ -0,0 +1,142 @@
+#include "Database.h"
+
+#include <stdexcept>
+
+//opens all connections, switches the database to WAL mode and fills the pool of readers
+Database::Database(const std::string& dbPath, const int readers, const std::chrono::milliseconds busyTimeout)
+    : busyTimeout(busyTimeout), readerSlots(readers) {
+    writerSlot.db = open(dbPath);
+    writer().exec("PRAGMA journal_mode=WAL;"
+                  "PRAGMA synchronous=NORMAL;", "Database: ");
+
+    for (auto& slot : readerSlots) {
+        slot.db = open(dbPath);
+        freeReaders.push_back(&slot);
+    }
+}
+
+//finalizes cached statements and closes every connection, all Connections must be given back by now
+Database::~Database() {
+    const auto close = [](const Slot& slot) {
+        for (const auto& [sql, stmt] : slot.statements) {
+            sqlite3_finalize(stmt);
+        }
+        sqlite3_close(slot.db);
+    };
+    close(writerSlot);
+    for (const auto& slot : readerSlots) {
+        close(slot);
+    }
+}
+
+sqlite3* Database::open(const std::string& dbPath) const {
+    sqlite3* db = nullptr;
+    if (sqlite3_open(dbPath.c_str(), &db)) {
+        sqlite3_close(db);
+        throw std::runtime_error("Could not open database");
+    }
+    sqlite3_busy_timeout(db, (int)busyTimeout.count());
+    return db;
+}
+
+//borrows the only writer connection, waits while another thread is writing
+Database::Connection Database::writer() {
+    writerMutex.lock();
+    return {this, &writerSlot, true};
+}
+
+//borrows one of the reader connections, waits while all of them are in use
+Database::Connection Database::reader() {
+    std::unique_lock<std::mutex> lock(readersMutex);
+    cvReaders.wait(lock, [&]() { return !freeReaders.empty(); });
+    Slot* slot = freeReaders.back();
+    freeReaders.pop_back();
+    return {this, slot, false};
+}
+
+void Database::release(Slot* slot, const bool isWriter) {
+    if (isWriter) {
+        writerMutex.unlock();
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(readersMutex);
+        freeReaders.push_back(slot);
+    }
+    cvReaders.notify_one();
+}
+
+Database::Connection::Connection(Database* database, Slot* slot, const bool isWriter)
+    : database(database), slot(slot), isWriter(isWriter) {}
+
+Database::Connection::Connection(Connection&& other) noexcept
+    : database(other.database), slot(other.slot), isWriter(other.isWriter), used(std::move(other.used)) {
+    other.database = nullptr;
+}
+
+//resets every statement used through this connection (so no read transaction stays open) and gives it back
+Database::Connection::~Connection() {
+    if (database == nullptr) {
+        return;
+    }
+    for (auto* stmt : used) {
+        sqlite3_reset(stmt);
+        sqlite3_clear_bindings(stmt);
+    }
+    database->release(slot, isWriter);
+}
+
+sqlite3* Database::Connection::get() const {
+    return slot->db;
+}
+
+//returns cached prepared statement for 'sql', prepares it on the first use
+sqlite3_stmt* Database::Connection::prepare(const std::string& sql) {
+    auto& stmt = slot->statements[sql];
+    if (stmt == nullptr && sqlite3_prepare_v2(slot->db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+        slot->statements.erase(sql);
+        throw std::runtime_error("Failed to prepare statement");
+    }
+    sqlite3_reset(stmt);
+    sqlite3_clear_bindings(stmt);
+    used.push_back(stmt);
+    return stmt;
+}
+
+/**
+ * Same as sqlite3_step. While the database file is locked by someone else SQLite itself retries
+ * for up to 'busyTimeout' (see 'open') before it returns SQLITE_BUSY
+ */
+int Database::Connection::step(sqlite3_stmt* stmt) const {
+    return sqlite3_step(stmt);
+}
+
+//runs 'sql' and throws with 'context' prefix on failure
+void Database::Connection::exec(const std::string& sql, const std::string& context) const {
+    char* errMsg = nullptr;
+    if (sqlite3_exec(slot->db, sql.c_str(), nullptr, nullptr, &errMsg) != SQLITE_OK) {
+        std::string error = context;
+        error += errMsg;
+        sqlite3_free(errMsg);
+        throw std::runtime_error(error);
+    }
+}
+
+//runs 'sql' as a single transaction which is rolled back if any of its statements fails, throws like 'exec'
+void Database::Connection::execTransaction(const std::string& sql, const std::string& context) const {
+    exec("BEGIN;", context);
+    try {
+        exec(sql + "COMMIT;", context);
+    } catch (...) {
+        sqlite3_exec(slot->db, "ROLLBACK;", nullptr, nullptr, nullptr);
+        throw;
+    }
+}
+
+//returns true if 'table' exists and has a column named 'column'
+bool Database::Connection::hasColumn(const std::string& table, const std::string& column) {
+    sqlite3_stmt* stmt = prepare("SELECT 1 FROM pragma_table_info(?) WHERE name = ?;");
+    sqlite3_bind_text(stmt, 1, table.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 2, column.c_str(), -1, SQLITE_STATIC);
+    return step(stmt) == SQLITE_ROW;
+}
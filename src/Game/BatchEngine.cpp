@@ -0,0 +1,123 @@
+#include "BatchEngine.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include "Random.h"
+
+namespace {
+    using Lanes = std::array<uint64_t, BatchEngine::WORDS>;
+
+    /**
+     * Mask whose every bit is set with probability 'probability' / 65536.
+     * Each lane reads a 16 bit random number spread over 16 words (one bit per word) and the lanes where
+     * that number is below 'probability' are found with one bitsliced comparison, most significant bit first.
+     * Trailing zero bits of 'probability' can not make a number smaller, so the comparison stops before them
+     */
+    uint64_t bernoulli(const uint32_t probability, uint64_t& state) {
+        if (probability == 0) {
+            return 0;
+        }
+        if (probability >= MemoryOneStrategy::ALWAYS) {
+            return ~0ULL;
+        }
+        uint64_t below = 0;
+        uint64_t equal = ~0ULL;
+        const int lowest = std::countr_zero(probability);
+        for (int bit = 15; bit >= lowest && equal; bit--) {
+            //SplitMix64 is fast enough to feed the bitsliced comparisons and good enough for simulations
+            const uint64_t random = splitMix64(state);
+            if ((probability >> bit) & 1) {
+                below |= equal & ~random;
+                equal &= random;
+            } else {
+                equal &= ~random;
+            }
+        }
+        return below;
+    }
+
+    //Moves of the next round for every lane, selected from the table of 'strategy' by the previous moves 'mine' and 'theirs'
+    void nextMoves(Lanes& moves, const Lanes& mine, const Lanes& theirs,
+                   const MemoryOneStrategy& strategy, uint64_t& state) {
+        for (int w = 0; w < BatchEngine::WORDS; w++) {
+            const uint64_t cc = ~mine[w] & ~theirs[w];
+            const uint64_t cd = ~mine[w] & theirs[w];
+            const uint64_t dc = mine[w] & ~theirs[w];
+            const uint64_t dd = mine[w] & theirs[w];
+            moves[w] = (cc & bernoulli(strategy.afterRound[0], state)) |
+                       (cd & bernoulli(strategy.afterRound[1], state)) |
+                       (dc & bernoulli(strategy.afterRound[2], state)) |
+                       (dd & bernoulli(strategy.afterRound[3], state));
+        }
+    }
+}
+
+MemoryOneStrategy MemoryOneStrategy::deterministic(std::string name, const Move first, const Move afterCC,
+                                                   const Move afterCD, const Move afterDC, const Move afterDD) {
+    const auto probability = [](const Move move) { return move == Move::STEAL ? ALWAYS : 0u; };
+    return {std::move(name), probability(first),
+            {probability(afterCC), probability(afterCD), probability(afterDC), probability(afterDD)}};
+}
+
+std::vector<MemoryOneStrategy> builtinMemoryOneStrategies() {
+    constexpr Move C = Move::SPLIT;
+    constexpr Move D = Move::STEAL;
+    constexpr uint32_t HALF = MemoryOneStrategy::ALWAYS / 2;
+    return {
+        MemoryOneStrategy::deterministic("TFT", C, C, D, C, D),
+        MemoryOneStrategy::deterministic("Grudger", C, C, D, D, D),
+        MemoryOneStrategy::deterministic("Pavlov", C, C, D, D, C),
+        {"Random", HALF, {HALF, HALF, HALF, HALF}},
+        MemoryOneStrategy::deterministic("AllC", C, C, C, C, C),
+        MemoryOneStrategy::deterministic("AllD", D, D, D, D, D),
+    };
+}
+
+BatchEngine::BatchEngine(const int rounds, const double noise)
+    : rounds(rounds), noise((uint32_t)std::lround(std::clamp(noise, 0.0, 1.0) * MemoryOneStrategy::ALWAYS)) {}
+
+/**
+ * Plays 'LANES' matches of 'first' against 'second', every lane with its own random stream derived from 'seed'.
+ * Returns total coins of both sides over all those matches
+ */
+BatchScore BatchEngine::playBatch(const MemoryOneStrategy& first, const MemoryOneStrategy& second,
+                                  const uint64_t seed) const {
+    uint64_t state = seed;
+    Lanes moves1{};
+    Lanes moves2{};
+    Lanes next1{};
+    Lanes next2{};
+    std::array<long long, 4> outcomes{};
+
+    for (int round = 0; round < rounds; round++) {
+        if (round == 0) {
+            for (int w = 0; w < WORDS; w++) {
+                next1[w] = bernoulli(first.first, state);
+                next2[w] = bernoulli(second.first, state);
+            }
+        } else {
+            nextMoves(next1, moves1, moves2, first, state);
+            nextMoves(next2, moves2, moves1, second, state);
+        }
+        for (int w = 0; w < WORDS; w++) {
+            moves1[w] = next1[w] ^ bernoulli(noise, state);
+            moves2[w] = next2[w] ^ bernoulli(noise, state);
+            outcomes[0] += std::popcount(~moves1[w] & ~moves2[w]);
+            outcomes[1] += std::popcount(~moves1[w] & moves2[w]);
+            outcomes[2] += std::popcount(moves1[w] & ~moves2[w]);
+            outcomes[3] += std::popcount(moves1[w] & moves2[w]);
+        }
+    }
+
+    BatchScore score;
+    score.matches = LANES;
+    const Move moves[4][2] = {{Move::SPLIT, Move::SPLIT}, {Move::SPLIT, Move::STEAL},
+                              {Move::STEAL, Move::SPLIT}, {Move::STEAL, Move::STEAL}};
+    for (int outcome = 0; outcome < 4; outcome++) {
+        const Payoff coins = payoff(moves[outcome][0], moves[outcome][1]);
+        score.score1 += outcomes[outcome] * coins.first;
+        score.score2 += outcomes[outcome] * coins.second;
+    }
+    return score;
+}
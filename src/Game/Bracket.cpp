@@ -0,0 +1,150 @@
+#include "Bracket.h"
+
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+
+Bracket::Bracket(const Format format, const int players, const int rounds)
+    : format(format), players(players), rounds(rounds) {
+    if (players < 2) {
+        throw std::invalid_argument("A tournament needs at least 2 players");
+    }
+    if (this->rounds <= 0) {
+        this->rounds = format == Format::ROUND_ROBIN ? players - 1 + players % 2
+                                                     : std::max(1, (int)std::bit_width((unsigned)players - 1));
+    }
+    for (int player = 0; player < players; player++) {
+        standings.push_back({player});
+    }
+    hadBye.assign(players, false);
+}
+
+//"swiss" or "round-robin", throws std::invalid_argument otherwise
+Bracket::Format Bracket::parseFormat(const std::string& name) {
+    if (name == "swiss") {
+        return Format::SWISS;
+    }
+    if (name == "round-robin") {
+        return Format::ROUND_ROBIN;
+    }
+    throw std::invalid_argument("Unknown tournament format: " + name);
+}
+
+uint64_t Bracket::key(const int first, const int second) {
+    return (uint64_t)std::min(first, second) << 32 | (uint32_t)std::max(first, second);
+}
+
+/**
+ * Pairings of the next round, a pair (player, BYE) means the player sits this round out and already got the point.
+ * Returns an empty list once all rounds were played
+ */
+std::vector<std::pair<int, int>> Bracket::nextRound() {
+    if (round >= rounds) {
+        return {};
+    }
+    std::vector<std::pair<int, int>> pairings = format == Format::ROUND_ROBIN ? roundRobinRound() : swissRound();
+    round++;
+    for (const auto& [first, second] : pairings) {
+        if (second == BYE) {
+            standings[first].points += 1;
+            hadBye[first] = true;
+        } else {
+            played.insert(key(first, second));
+        }
+    }
+    return pairings;
+}
+
+/**
+ * Circle method: entrant 0 stays, the others rotate by one seat every round and seat i plays seat n - 1 - i.
+ * With an odd count a dummy entrant is added, whoever meets it has a bye
+ */
+std::vector<std::pair<int, int>> Bracket::roundRobinRound() const {
+    const int seats = players + players % 2;
+    const auto atSeat = [&](const int seat) {
+        const int player = seat == 0 ? 0 : (seat - 1 + round) % (seats - 1) + 1;
+        return player < players ? player : BYE;
+    };
+    std::vector<std::pair<int, int>> pairings;
+    for (int seat = 0; seat < seats / 2; seat++) {
+        const int first = atSeat(seat);
+        const int second = atSeat(seats - 1 - seat);
+        if (first == BYE) {
+            pairings.emplace_back(second, BYE);
+        } else {
+            pairings.emplace_back(first, second);
+        }
+    }
+    return pairings;
+}
+
+/**
+ * Orders entrants by standing and pairs each unpaired one with the next unpaired entrant it has not met yet,
+ * falling back to a rematch only when everybody below was met already
+ */
+std::vector<std::pair<int, int>> Bracket::swissRound() {
+    std::vector<int> order;
+    for (const Standing& standing : getStandings()) {
+        order.push_back(standing.player);
+    }
+
+    std::vector<std::pair<int, int>> pairings;
+    if (players % 2 == 1) {
+        auto bye = std::find_if(order.rbegin(), order.rend(), [&](const int player) { return !hadBye[player]; });
+        if (bye == order.rend()) {
+            bye = order.rbegin();
+        }
+        pairings.emplace_back(*bye, BYE);
+        order.erase(std::next(bye).base());
+    }
+
+    std::vector<bool> paired(order.size(), false);
+    for (size_t i = 0; i < order.size(); i++) {
+        if (paired[i]) {
+            continue;
+        }
+        size_t opponent = order.size();
+        for (size_t j = i + 1; j < order.size(); j++) {
+            if (!paired[j] && !played.contains(key(order[i], order[j]))) {
+                opponent = j;
+                break;
+            }
+        }
+        if (opponent == order.size()) {
+            for (size_t j = i + 1; j < order.size() && opponent == order.size(); j++) {
+                opponent = paired[j] ? opponent : j;
+            }
+        }
+        paired[i] = true;
+        paired[opponent] = true;
+        pairings.emplace_back(order[i], order[opponent]);
+    }
+    return pairings;
+}
+
+//Records the coins both entrants of a pairing collected, whoever has more wins
+void Bracket::report(const int first, const int second, const int coins1, const int coins2) {
+    standings[first].coins += coins1;
+    standings[second].coins += coins2;
+    standings[first].games++;
+    standings[second].games++;
+    standings[first].points += coins1 > coins2 ? 1 : coins1 == coins2 ? 0.5 : 0;
+    standings[second].points += coins2 > coins1 ? 1 : coins1 == coins2 ? 0.5 : 0;
+}
+
+//Standings best first: most points, then most coins
+std::vector<Bracket::Standing> Bracket::getStandings() const {
+    std::vector<Standing> sorted = standings;
+    std::ranges::stable_sort(sorted, [](const Standing& a, const Standing& b) {
+        return a.points != b.points ? a.points > b.points : a.coins > b.coins;
+    });
+    return sorted;
+}
+
+int Bracket::getRound() const {
+    return round;
+}
+
+int Bracket::getRounds() const {
+    return rounds;
+}
@@ -0,0 +1,100 @@
+#include "Broadcast.h"
+
+Broadcast::Broadcast(std::string title) : title(std::move(title)) {}
+
+/**
+ * Adds a spectator writing to 'socket', which is switched to non-blocking mode until 'unsubscribe'.
+ * The newest round result is queued at once, so the spectator sees the current standings without waiting.
+ * Returns false if the game is already over
+ */
+bool Broadcast::subscribe(const SOCKET socket) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (closed) {
+        return false;
+    }
+    u_long nonBlocking = 1;
+    ioctlsocket(socket, FIONBIO, &nonBlocking);
+    Subscriber& subscriber = subscribers[socket];
+    if (latest) {
+        subscriber.pending.push_back(latest);
+        write(socket, subscriber);
+    }
+    return true;
+}
+
+//Removes the spectator writing to 'socket' and puts the socket back to blocking mode
+void Broadcast::unsubscribe(const SOCKET socket) {
+    std::lock_guard<std::mutex> lock(mutex);
+    subscribers.erase(socket);
+    u_long nonBlocking = 0;
+    ioctlsocket(socket, FIONBIO, &nonBlocking);
+}
+
+//Serializes 'message' once and fans it out to every spectator, dropping older results of those who fell behind
+void Broadcast::publish(const std::string& message) {
+    const auto buffer = std::make_shared<const std::string>(message);
+    std::lock_guard<std::mutex> lock(mutex);
+    latest = buffer;
+    for (auto& [socket, subscriber] : subscribers) {
+        const size_t keep = subscriber.offset > 0 ? 1 : 0;
+        while (subscriber.pending.size() >= MAX_PENDING && subscriber.pending.size() > keep) {
+            subscriber.pending.erase(subscriber.pending.begin() + (long)keep);
+        }
+        subscriber.pending.push_back(buffer);
+        write(socket, subscriber);
+    }
+}
+
+//Writes what is pending for the spectator on 'socket', returns true if something is still left
+bool Broadcast::flush(const SOCKET socket) {
+    std::lock_guard<std::mutex> lock(mutex);
+    const auto found = subscribers.find(socket);
+    if (found == subscribers.end()) {
+        return false;
+    }
+    write(socket, found->second);
+    return !found->second.pending.empty();
+}
+
+//Marks the game as over, spectators still get what is pending for them
+void Broadcast::close() {
+    std::lock_guard<std::mutex> lock(mutex);
+    closed = true;
+}
+
+/**
+ * Writes pending results until the socket would block. A failing socket loses its pending results,
+ * the spectator's thread notices the broken connection when reading it
+ */
+void Broadcast::write(const SOCKET socket, Subscriber& subscriber) {
+    while (!subscriber.pending.empty()) {
+        const std::string& buffer = *subscriber.pending.front();
+        const int sent = send(socket, buffer.data() + subscriber.offset, (int)(buffer.size() - subscriber.offset), 0);
+        if (sent == SOCKET_ERROR) {
+            if (WSAGetLastError() != WSAEWOULDBLOCK) {
+                subscriber.pending.clear();
+                subscriber.offset = 0;
+            }
+            return;
+        }
+        subscriber.offset += sent;
+        if (subscriber.offset == buffer.size()) {
+            subscriber.pending.pop_front();
+            subscriber.offset = 0;
+        }
+    }
+}
+
+const std::string& Broadcast::getTitle() const {
+    return title;
+}
+
+bool Broadcast::isClosed() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return closed;
+}
+
+size_t Broadcast::getSpectators() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return subscribers.size();
+}
@@ -0,0 +1,155 @@
+#include "GameRules.h"
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+
+GameRules::GameRules() {
+    buildTable();
+}
+
+/**
+ * Builds rules from 'spec' (see the class description).
+ * Throws std::invalid_argument if a key is unknown or a value does not make sense
+ */
+GameRules GameRules::parse(const std::string& spec) {
+    GameRules rules;
+    std::string settings = spec;
+    if (const size_t colon = spec.find(':'); colon != std::string::npos) {
+        rules.name = spec.substr(0, colon);
+        settings = spec.substr(colon + 1);
+    } else if (spec.find('=') == std::string::npos) {
+        rules.name = spec;
+        settings.clear();
+    }
+    if (rules.name.empty()) {
+        throw std::invalid_argument("Game variant needs a name: " + spec);
+    }
+    if (rules.name.size() > MAX_NAME_LENGTH) {
+        throw std::invalid_argument("Game variant name is longer than " + std::to_string(MAX_NAME_LENGTH) +
+                                    " characters: " + rules.name);
+    }
+
+    std::stringstream stream(settings);
+    for (std::string setting; std::getline(stream, setting, ',');) {
+        const size_t equals = setting.find('=');
+        const std::string key = setting.substr(0, equals);
+        const std::string value = equals == std::string::npos ? "" : setting.substr(equals + 1);
+
+        if (key == "payoff") {
+            int coins[4];
+            char separator;
+            std::stringstream values(value);
+            values >> coins[0] >> separator >> coins[1] >> separator >> coins[2] >> separator >> coins[3];
+            if (!values) {
+                throw std::invalid_argument("payoff needs 4 numbers: " + value);
+            }
+            rules.matrix = {coins[0], coins[1], coins[2], coins[3]};
+        } else if (key == "rounds" && value.starts_with("~")) {
+            rules.meanRounds = std::stod(value.substr(1));
+            if (rules.meanRounds < 1) {
+                throw std::invalid_argument("mean number of rounds must be at least 1: " + value);
+            }
+        } else if (key == "rounds") {
+            const size_t dash = value.find('-');
+            rules.minRounds = std::stoi(value.substr(0, dash));
+            rules.maxRounds = dash == std::string::npos ? rules.minRounds : std::stoi(value.substr(dash + 1));
+            rules.meanRounds = 0;
+            if (rules.minRounds < 1 || rules.maxRounds < rules.minRounds || rules.maxRounds > MAX_ROUNDS) {
+                throw std::invalid_argument("rounds must be a range within 1-" + std::to_string(MAX_ROUNDS) + ": " + value);
+            }
+        } else if (key == "noise") {
+            rules.noise = std::stod(value);
+            if (rules.noise < 0 || rules.noise > 1) {
+                throw std::invalid_argument("noise must be a probability: " + value);
+            }
+        } else if (key == "players") {
+            rules.players = std::stoi(value);
+            if (rules.players < 2 || rules.players > MAX_PLAYERS) {
+                throw std::invalid_argument("players must be within 2-" + std::to_string(MAX_PLAYERS) + ": " + value);
+            }
+        } else if (key == "goods") {
+            rules.goods = std::stoi(value);
+        } else {
+            throw std::invalid_argument("Unknown game variant setting: " + setting);
+        }
+    }
+    if (rules.goods != 0 && (rules.goods <= 1 || rules.goods >= rules.players)) {
+        throw std::invalid_argument("goods must be more than 1 and less than players: " + std::to_string(rules.goods));
+    }
+    rules.buildTable();
+    return rules;
+}
+
+//Precomputes coins for both moves and every possible number of splitting others, the round loop only indexes it
+void GameRules::buildTable() {
+    for (const Move move : {Move::SPLIT, Move::STEAL}) {
+        std::vector<int>& row = table[(int)move];
+        row.assign(players, 0);
+        for (int splitting = 0; splitting < players; splitting++) {
+            const int stealing = players - 1 - splitting;
+            if (goods != 0) {
+                row[splitting] = move == Move::SPLIT ? goods * (splitting + 1) : players + goods * splitting;
+            } else {
+                row[splitting] = splitting * matrix[(int)move * 2] + stealing * matrix[(int)move * 2 + 1];
+            }
+        }
+    }
+}
+
+const std::string& GameRules::getName() const {
+    return name;
+}
+
+int GameRules::getPlayers() const {
+    return players;
+}
+
+int GameRules::coins(const Move move, const int splittingOthers) const {
+    return table[(int)move][splittingOthers];
+}
+
+/**
+ * Number of rounds of a new match. A geometric number of rounds is the inverse of its distribution function applied
+ * to a uniform draw, so it only needs one draw from 'generator' (see Xoshiro256 for why no <random> distribution)
+ */
+int GameRules::drawRounds(Xoshiro256& generator) const {
+    if (meanRounds > 0) {
+        const double failures = std::floor(std::log1p(-generator.unit()) / std::log1p(-1.0 / meanRounds));
+        return 1 + (int)std::min(failures, (double)MAX_ROUNDS - 1);
+    }
+    return minRounds + (int)generator.below((uint32_t)(maxRounds - minRounds + 1));
+}
+
+//Flips 'move' with probability 'noise'
+Move GameRules::applyNoise(const Move move, Xoshiro256& generator) const {
+    if (noise > 0 && generator.unit() < noise) {
+        return move == Move::STEAL ? Move::SPLIT : Move::STEAL;
+    }
+    return move;
+}
+
+/**
+ * Replays a stored two player match: checks that 'seed' gives the number of rounds 'moves' has and returns
+ * the coins of both players, which divided by the rounds are the averages the match was stored with.
+ * Throws std::runtime_error for rules with more players (a pairwise match does not hold the other seats)
+ * or if the match could not have been played with 'seed' under these rules
+ */
+std::pair<int, int> GameRules::replay(const uint64_t seed, const MoveLog& moves) const {
+    if (players != 2) {
+        throw std::runtime_error("Only two player matches can be replayed, variant " + name + " seats " +
+                                 std::to_string(players));
+    }
+    Xoshiro256 generator(seed);
+    if (drawRounds(generator) != moves.getRounds()) {
+        throw std::runtime_error("Match was not played with seed " + std::to_string(seed) + " in variant " + name);
+    }
+    std::pair<int, int> coins;
+    for (int round = 0; round < moves.getRounds(); round++) {
+        const auto [move1, move2] = moves.getRound(round);
+        coins.first += this->coins(move1, move2 == Move::SPLIT);
+        coins.second += this->coins(move2, move1 == Move::SPLIT);
+    }
+    return coins;
+}
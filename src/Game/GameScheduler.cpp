@@ -0,0 +1,128 @@
+#include "GameScheduler.h"
+
+#include <algorithm>
+
+GameScheduler::GameScheduler(const int threads) {
+    for (int i = 0; i < std::max(threads, 1); i++) {
+        workers.emplace_back(&GameScheduler::work, this);
+    }
+}
+
+GameScheduler::~GameScheduler() {
+    stop();
+}
+
+//Stops the workers, games still in progress are dropped
+void GameScheduler::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    cvWork.notify_all();
+    for (auto& worker : workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+//Takes over 'session' and steps it for the first time as soon as a worker is free
+void GameScheduler::add(const int gameId, std::unique_ptr<GameSession> session) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        Game& game = games[gameId];
+        game.session = std::move(session);
+        game.wakeAt = Clock::now();
+        game.queued = true;
+        ready.push_back(gameId);
+    }
+    cvWork.notify_one();
+}
+
+/**
+ * Steps 'gameId' again soon, called when something the game waits for happened.
+ * A game being stepped right now is stepped once more afterwards, so no wake up is lost
+ */
+void GameScheduler::wake(const int gameId) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        const auto found = games.find(gameId);
+        if (found == games.end()) {
+            return;
+        }
+        Game& game = found->second;
+        if (game.running) {
+            game.woken = true;
+            return;
+        }
+        if (game.queued) {
+            return;
+        }
+        game.queued = true;
+        ready.push_back(gameId);
+    }
+    cvWork.notify_one();
+}
+
+size_t GameScheduler::getGames() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return games.size();
+}
+
+/**
+ * Loop of every worker: takes a woken game or one whose timer expired, steps it without holding the lock
+ * and files it under its next wake up time. Timers left behind by games which were woken earlier are skipped
+ */
+void GameScheduler::work() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!stopping) {
+        int gameId = 0;
+        if (!ready.empty()) {
+            gameId = ready.front();
+            ready.pop_front();
+        } else if (!timers.empty() && timers.top().first <= Clock::now()) {
+            const auto [wakeAt, id] = timers.top();
+            timers.pop();
+            const auto found = games.find(id);
+            if (found == games.end() || found->second.wakeAt != wakeAt || found->second.queued || found->second.running) {
+                continue;
+            }
+            gameId = id;
+        } else {
+            if (timers.empty()) {
+                cvWork.wait(lock);
+            } else {
+                cvWork.wait_until(lock, timers.top().first);
+            }
+            continue;
+        }
+
+        const auto found = games.find(gameId);
+        if (found == games.end()) {
+            continue;
+        }
+        Game& game = found->second;
+        game.queued = false;
+        game.running = true;
+        game.woken = false;
+
+        lock.unlock();
+        const std::optional<Clock::time_point> next = game.session->step();
+        lock.lock();
+
+        game.running = false;
+        if (!next) {
+            games.erase(gameId);
+            continue;
+        }
+        game.wakeAt = *next;
+        if (game.woken) {
+            game.queued = true;
+            ready.push_back(gameId);
+        } else if (*next != Clock::time_point::max()) {
+            timers.emplace(*next, gameId);
+            //Another worker may be sleeping until a later timer
+            cvWork.notify_one();
+        }
+    }
+}
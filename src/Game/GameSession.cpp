@@ -1,99 +1,308 @@
 #include "GameSession.h"
 #include "HelperFunctions.h"
-#include <random>
-
-GameSession::GameSession(std::string player1, const SOCKET client1Socket, std::string player2, const SOCKET client2Socket,
-                         std::mutex& playingMutex, std::condition_variable& cvPlaying,
-                         std::unordered_set<std::string>& playingUsers, std::mutex& matchDaoMutex,
-                         std::shared_ptr<MatchDAO> matchDAO)
-    : player1(std::move(player1)), client1Socket(client1Socket),
-      player2(std::move(player2)), client2Socket(client2Socket),
-      playingMutex(playingMutex), cvPlaying(cvPlaying), playingUsers(playingUsers),
-      matchDaoMutex(matchDaoMutex), matchDAO(std::move(matchDAO)) {
-    score1 = 0;
-    score2 = 0;
-}
-
-void GameSession::updateScores(const std::string& player1Str, const std::string& player2Str) {
-    if (player1Str == "SPLIT") {
-        if (player2Str == "SPLIT") {
-            score1 += 3;
-            score2 += 3;
-        } else {
-            score1 += 0;
-            score2 += 5;
+#include <algorithm>
+#include <iostream>
+
+GameSession::GameSession(const int gameId, std::vector<Participant> players,
+                         std::mutex& playingMutex, std::condition_variable& cvPlaying, std::shared_ptr<MatchDAO> matchDAO,
+                         std::shared_ptr<const GameRules> rules, std::shared_ptr<Broadcast> broadcast,
+                         const uint64_t seed)
+    : gameId(gameId), tag("#" + std::to_string(gameId) + " "), players(std::move(players)),
+      rules(std::move(rules)), seed(seed), generator(seed), broadcast(std::move(broadcast)),
+      playingMutex(playingMutex), cvPlaying(cvPlaying),
+      matchDAO(std::move(matchDAO)) {
+    scores.assign(this->players.size(), 0);
+    history.resize(this->players.size());
+    writers.resize(this->players.size());
+    paced = std::ranges::any_of(this->players, [](const Participant& player) { return !player.bot && !player.binary; });
+    resumeAt = after(std::chrono::seconds(1));
+}
+
+//When a pause of 'pause' started now ends, right now at a table where nobody needs time to read
+GameSession::Clock::time_point GameSession::after(const std::chrono::seconds pause) const {
+    return paced ? Clock::now() + pause : Clock::now();
+}
+
+/**
+ * Sends 'message' of game 'gameId' to a client, messages to bots and binary clients are dropped.
+ * A client playing several games at once gets every line prefixed with "#<gameId> " and always newline terminated
+ */
+void GameSession::send(const Participant& participant, const int gameId, const std::string& message) {
+    if (participant.bot || participant.binary) {
+        return;
+    }
+    if (!participant.inbox || !participant.inbox->isTagged()) {
+        participant.outbox->post(message);
+        return;
+    }
+    const std::string tag = "#" + std::to_string(gameId) + " ";
+    MessageWriter writer;
+    writer.begin(tag);
+    writer.add(message).sendTo(*participant.outbox);
+}
+
+//Starts a new message to the player at 'seat' in the writer kept for that seat
+MessageWriter& GameSession::message(const size_t seat) {
+    const Participant& participant = players[seat];
+    MessageWriter& writer = writers[seat];
+    writer.begin(participant.inbox && participant.inbox->isTagged() ? std::string_view(tag) : std::string_view());
+    return writer;
+}
+
+void GameSession::send(const size_t seat) {
+    if (!players[seat].bot) {
+        writers[seat].sendTo(*players[seat].outbox);
+    }
+}
+
+//Sends the frame which was just built to the player at 'seat'
+void GameSession::sendFrame(const size_t seat) {
+    frame.sendTo(*players[seat].outbox);
+}
+
+//"<username>: <coins>" line of every player
+void GameSession::addScores(MessageWriter& writer) const {
+    for (size_t seat = 0; seat < players.size(); seat++) {
+        writer.add(players[seat].username.str()).add(": ").add(scores[seat]).add("\n");
+    }
+}
+
+void GameSession::setOnFinished(std::function<void(const std::vector<int>& scores)> callback) {
+    onFinished = std::move(callback);
+}
+
+/**
+ * Move of the player at 'seat' for this round: a bot asks its strategy, a client's move is taken from its inbox
+ * (std::nullopt while it has not arrived yet). Bots see a single opponent, at a bigger table 'opponentLast'
+ * is STEAL if anybody else stole last round. A client who disconnected SPLITs
+ */
+std::optional<Move> GameSession::readMove(const size_t seat, const Move opponentLast) const {
+    const Participant& participant = players[seat];
+    if (participant.bot) {
+        const int round = (int)history[seat].size();
+        return participant.bot->next(round, round > 0 ? history[seat].back() : Move::SPLIT, opponentLast);
+    }
+    return participant.inbox->poll(gameId);
+}
+
+/**
+ * Advances the game as far as it gets without waiting and returns when it wants to be stepped again:
+ * the end of a pause, Clock::time_point::max() while it waits for moves (the inboxes wake it up) or
+ * std::nullopt once the game is over and its players are released
+ */
+std::optional<GameSession::Clock::time_point> GameSession::step() {
+    for (;;) {
+        switch (state) {
+            case State::STARTING:
+                if (Clock::now() < resumeAt) {
+                    return resumeAt;
+                }
+                start();
+                state = State::PROMPTING;
+                break;
+            case State::PROMPTING:
+                prompt();
+                state = State::COLLECTING;
+                break;
+            case State::COLLECTING:
+                if (!collectMoves()) {
+                    return Clock::time_point::max();
+                }
+                scoreRound();
+                resumeAt = after(std::chrono::seconds(1));
+                state = State::SHOWING;
+                break;
+            case State::SHOWING:
+                if (Clock::now() < resumeAt) {
+                    return resumeAt;
+                }
+                if ((int)history.front().size() < roundNumber) {
+                    state = State::PROMPTING;
+                    break;
+                }
+                finish();
+                resumeAt = after(std::chrono::seconds(2));
+                state = State::FINISHING;
+                break;
+            case State::FINISHING:
+                if (Clock::now() < resumeAt) {
+                    return resumeAt;
+                }
+                release();
+                return std::nullopt;
         }
-    } else {
-        if (player2Str == "SPLIT") {
-            score1 += 5;
-            score2 += 0;
-        } else {
-            score1 += 1;
-            score2 += 1;
+    }
+}
+
+//The number of rounds is the first draw of the game (see GameRules::replay), every bot gets a stream of its own
+void GameSession::start() {
+    roundNumber = rules->drawRounds(generator);
+    for (size_t seat = 0; seat < players.size(); seat++) {
+        if (players[seat].bot) {
+            players[seat].bot->reset(streamSeed(seed, seat + 1));
+        }
+    }
+}
+
+void GameSession::prompt() {
+    frame.begin(FrameType::MOVE_REQUEST).put32(gameId).put16((uint16_t)(history.front().size() + 1));
+    for (size_t seat = 0; seat < players.size(); seat++) {
+        if (players[seat].binary) {
+            sendFrame(seat);
+        } else if (!players[seat].bot) {
+            message(seat).add(MessageWriter::PROMPT);
+            send(seat);
         }
     }
+    roundMoves.assign(players.size(), std::nullopt);
 }
 
+//Takes every move of this round which is there already, returns true once all players moved
+bool GameSession::collectMoves() {
+    int lastStealing = 0;
+    for (size_t seat = 0; seat < players.size(); seat++) {
+        lastStealing += !history[seat].empty() && history[seat].back() == Move::STEAL;
+    }
+
+    bool complete = true;
+    for (size_t seat = 0; seat < players.size(); seat++) {
+        if (!roundMoves[seat]) {
+            const bool stoleLast = !history[seat].empty() && history[seat].back() == Move::STEAL;
+            roundMoves[seat] = readMove(seat, lastStealing - stoleLast > 0 ? Move::STEAL : Move::SPLIT);
+            complete &= roundMoves[seat].has_value();
+        }
+    }
+    return complete;
+}
 
-void GameSession::playRound() {
-    sendToClient(client1Socket, "Do you want to split or steal? (SPLIT/STEAL): ");
-    sendToClient(client2Socket, "Do you want to split or steal? (SPLIT/STEAL): ");
+void GameSession::scoreRound() {
+    const size_t count = players.size();
 
-    std::string player1Str = receiveFromClient(client1Socket);
-    std::string player2Str = receiveFromClient(client2Socket);
-    if (player1Str != "STEAL") {
-        player1Str = "SPLIT";
+    //With noise a move may be flipped after it was chosen, everybody only ever learns the move which counted
+    std::vector<Move> moves(count);
+    int stealing = 0;
+    for (size_t seat = 0; seat < count; seat++) {
+        moves[seat] = rules->applyNoise(*roundMoves[seat], generator);
+        stealing += moves[seat] == Move::STEAL;
     }
-    if (player2Str != "STEAL") {
-        player2Str = "SPLIT";
+
+    for (size_t seat = 0; seat < count; seat++) {
+        const bool stole = moves[seat] == Move::STEAL;
+        scores[seat] += rules->coins(moves[seat], (int)count - stealing - (stole ? 0 : 1));
+        history[seat].push_back(moves[seat]);
     }
+    const auto moveName = [](const Move move) { return move == Move::STEAL ? MessageWriter::STEAL : MessageWriter::SPLIT; };
 
-    updateScores(player1Str, player2Str);
+    if (broadcast) {
+        feed.begin();
+        feed.add("Round ").add((int)history.front().size()).add(":");
+        for (size_t seat = 0; seat < count; seat++) {
+            feed.add(seat == 0 ? " " : ", ").add(players[seat].username.str()).add(" ").add(moveName(moves[seat]));
+        }
+        feed.add("\n");
+        addScores(feed);
+        broadcast->publish(feed.add("\n").str());
+    }
 
-    const std::string currentScores = player1 + ": " + std::to_string(score1) + "\n" +
-                                      player2 + ": " + std::to_string(score2) + "\n";
-    sendToClient(client1Socket, "Your opponent chose to: " + player2Str + "!\n\n" + currentScores);
-    sendToClient(client2Socket, "Your opponent chose to: " + player1Str + "\n\n" + currentScores);
-    std::this_thread::sleep_for(std::chrono::seconds(1));
+    frame.begin(FrameType::ROUND_RESULT).put32(gameId).put16((uint16_t)history.front().size()).put8((uint8_t)count);
+    for (size_t seat = 0; seat < count; seat++) {
+        frame.put8((uint8_t)moves[seat]).put32((uint32_t)scores[seat]);
+    }
+    for (size_t seat = 0; seat < count; seat++) {
+        if (players[seat].binary) {
+            sendFrame(seat);
+        }
+        if (players[seat].bot || players[seat].binary) {
+            continue;
+        }
+        MessageWriter& writer = message(seat);
+        if (count == 2) {
+            writer.add("Your opponent chose to: ").add(moveName(moves[1 - seat])).add("!\n\n");
+        } else {
+            const int othersStealing = stealing - (moves[seat] == Move::STEAL);
+            writer.add("Your opponents: ").add((int)count - 1 - othersStealing).add(" split, ")
+                  .add(othersStealing).add(" stole!\n\n");
+        }
+        addScores(writer);
+        send(seat);
+    }
 }
 
-void GameSession::runGame() {
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<> distribution(3, 5);
-    const int roundNumber = distribution(gen);
-
-    for (int i = 0; i < roundNumber; i++) {
-        playRound();
+//Stores the game as pairwise matches (see the class description), a failed store is logged and does not end the game
+void GameSession::saveMatches(const int rounds) const {
+    const size_t count = players.size();
+    for (size_t first = 0; first < count; first += 2) {
+        const size_t second = (first + 1) % count;
+        MoveLog moves;
+        for (int round = 0; round < rounds; round++) {
+            moves.record(history[first][round], history[second][round]);
+        }
+        try {
+            matchDAO->addMatch(Match(players[first].userId, (double)scores[first] / rounds,
+                                     players[second].userId, (double)scores[second] / rounds, moves, seed,
+                                     rules->getName(), (int)count));
+        } catch (const std::exception& e) {
+            std::cerr << "Match between " << players[first].username.str() << " and "
+                      << players[second].username.str() << " was not saved: " << e.what() << std::endl;
+        }
     }
+}
 
-    const double average1 = (double) score1 / roundNumber;
-    const double average2 = (double) score2 / roundNumber;
-    const std::string finalMessage = "Match is over!\nYour final average scores are:\n" +
-                                    player1 + ": " + std::to_string(average1) + "\n" +
-                                    player2 + ": " + std::to_string(average2) + "\n\n";
-    {
-        const Match match(player1, average1, player2, average2);
-        std::lock_guard<std::mutex> lock(matchDaoMutex);
-        matchDAO->addMatch(match);
+//Tells everybody the final scores, stores the matches and reports the result to whoever waits for it (a tournament)
+void GameSession::finish() {
+    const auto addAverages = [&](MessageWriter& writer) {
+        for (size_t seat = 0; seat < players.size(); seat++) {
+            writer.add(players[seat].username.str()).add(": ").add((double)scores[seat] / roundNumber).add("\n");
+        }
+        writer.add("\n");
+    };
+    saveMatches(roundNumber);
+    if (broadcast) {
+        feed.begin();
+        feed.add("Match is over!\nFinal average scores:\n");
+        addAverages(feed);
+        broadcast->publish(feed.str());
+        broadcast->close();
     }
 
-    if (score1 > score2) {
-        sendToClient(client1Socket, finalMessage + "You won the match!\n");
-        sendToClient(client2Socket, finalMessage + "You lost the match!\n");
-    } else if (score2 > score1) {
-        sendToClient(client1Socket, finalMessage + "You lost the match!\n");
-        sendToClient(client2Socket, finalMessage + "You won the match!\n");
-    } else {
-        sendToClient(client1Socket, finalMessage + "Draw!\n");
-        sendToClient(client2Socket, finalMessage + "Draw!\n");
+    const int best = *std::ranges::max_element(scores);
+    const auto winners = std::ranges::count(scores, best);
+    for (size_t seat = 0; seat < players.size(); seat++) {
+        if (players[seat].binary) {
+            frame.begin(FrameType::GAME_OVER).put32(gameId).put8((uint8_t)players.size());
+            for (const int score : scores) {
+                frame.putDouble((double)score / roundNumber);
+            }
+            frame.put8(scores[seat] < best ? 0 : winners == 1 ? 1 : 2);
+            sendFrame(seat);
+        }
+        if (players[seat].bot || players[seat].binary) {
+            continue;
+        }
+        MessageWriter& writer = message(seat);
+        writer.add("Match is over!\nYour final average scores are:\n");
+        addAverages(writer);
+        if (scores[seat] < best) {
+            writer.add("You lost the match!\n");
+        } else {
+            writer.add(winners == 1 ? "You won the match!\n" : "Draw!\n");
+        }
+        send(seat);
     }
-    std::this_thread::sleep_for(std::chrono::seconds(2));
+    if (onFinished) {
+        onFinished(scores);
+    }
+}
 
+//Lets the clients go back to their menus
+void GameSession::release() {
     {
         std::lock_guard<std::mutex> lock(playingMutex);
-        playingUsers.erase(player1);
-        playingUsers.erase(player2);
+        for (const Participant& participant : players) {
+            if (!participant.bot) {
+                participant.inbox->release(gameId);
+            }
+        }
     }
     cvPlaying.notify_all();
 }
@@ -0,0 +1,99 @@
+#include "InMemoryMatchDao.h"
+#include <algorithm>
+
+InMemoryMatchDAO::InMemoryMatchDAO(std::shared_ptr<UserDAO> userDao)
+    : userDao(std::move(userDao)) {}
+
+void InMemoryMatchDAO::addScore(const int userId, const double score) const {
+    auto& shard = totalsShards[(size_t)userId % SHARDS];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto& [sum, count] = shard.totals[userId];
+    sum += score;
+    count++;
+}
+
+//Adds certain match to the memory and returns its id
+int InMemoryMatchDAO::addMatch(const Match& match) const {
+    addScore(match.getUser1Id(), match.getScore1());
+    addScore(match.getUser2Id(), match.getScore2());
+
+    const int id = nextId++;
+    auto& shard = matchesShards[(size_t)id % SHARDS];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    shard.matches.emplace(id, match);
+    return id;
+}
+
+//Returns moves of the match with id 'matchId' or empty MoveLog if there is no such match
+MoveLog InMemoryMatchDAO::getMoveLog(const int matchId) const {
+    auto& shard = matchesShards[(size_t)matchId % SHARDS];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    if (const auto it = shard.matches.find(matchId); it != shard.matches.end()) {
+        return it->second.getMoves();
+    }
+    return {};
+}
+
+//Returns seed of the game the match with id 'matchId' was played in, 0 if there is no such match
+uint64_t InMemoryMatchDAO::getSeed(const int matchId) const {
+    auto& shard = matchesShards[(size_t)matchId % SHARDS];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    if (const auto it = shard.matches.find(matchId); it != shard.matches.end()) {
+        return it->second.getSeed();
+    }
+    return 0;
+}
+
+//Returns variant and table size of the game the match with id 'matchId' was played in, {"", 0} if there is no such match
+std::pair<std::string, int> InMemoryMatchDAO::getVariant(const int matchId) const {
+    auto& shard = matchesShards[(size_t)matchId % SHARDS];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    if (const auto it = shard.matches.find(matchId); it != shard.matches.end()) {
+        return {it->second.getVariant(), it->second.getPlayers()};
+    }
+    return {};
+}
+
+//Returns the average scores both players of the match with id 'matchId' were stored with, {0, 0} if there is no such match
+std::pair<double, double> InMemoryMatchDAO::getScores(const int matchId) const {
+    auto& shard = matchesShards[(size_t)matchId % SHARDS];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    if (const auto it = shard.matches.find(matchId); it != shard.matches.end()) {
+        return {it->second.getScore1(), it->second.getScore2()};
+    }
+    return {};
+}
+
+//This function returns username and average of all scores of the user with id 'userId'
+std::pair<std::string, double> InMemoryMatchDAO::getAverageScore(const int userId) const {
+    double avgScore = 0.0;
+    {
+        auto& shard = totalsShards[(size_t)userId % SHARDS];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        if (const auto it = shard.totals.find(userId); it != shard.totals.end()) {
+            avgScore = it->second.first / it->second.second;
+        }
+    }
+    return std::make_pair(userDao->getUserById(userId).getUsername(), avgScore);
+}
+
+//This function returns top 'num' players
+std::vector<std::pair<std::string, double>> InMemoryMatchDAO::getTopPlayers(const int num) const {
+    std::vector<std::pair<int, double>> averages;
+    for (auto& shard : totalsShards) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        for (const auto& [userId, total] : shard.totals) {
+            averages.emplace_back(userId, total.first / total.second);
+        }
+    }
+
+    const auto top = averages.begin() + std::min((size_t)std::max(num, 0), averages.size());
+    std::partial_sort(averages.begin(), top, averages.end(),
+        [](const auto& a, const auto& b) { return a.second > b.second; });
+
+    std::vector<std::pair<std::string, double>> topPlayers;
+    for (auto it = averages.begin(); it != top; ++it) {
+        topPlayers.emplace_back(userDao->getUserById(it->first).getUsername(), it->second);
+    }
+    return topPlayers;
+}
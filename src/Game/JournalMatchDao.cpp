@@ -0,0 +1,412 @@
+#include "JournalMatchDao.h"
+
+#include <io.h>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <filesystem>
+#include <stdexcept>
+#include <utility>
+#include "GameRules.h"
+
+namespace {
+    constexpr int MAX_ROUNDS = 112;
+
+    /**
+     * Layout of a single journal record. Fixed size, so the n-th match always starts at n * sizeof(JournalRecord)
+     * (the header takes slot 0). 'checksum' is CRC-32 of all the bytes before it
+     */
+    struct JournalRecord {
+        static constexpr uint32_t MAGIC = 0x334A4450; // "PDJ3"
+
+        uint32_t magic;
+        int32_t user1Id;
+        int32_t user2Id;
+        uint16_t rounds;
+        uint8_t players;
+        uint8_t reserved;
+        uint64_t seed;
+        double score1;
+        double score2;
+        //Name of the game variant, NUL padded
+        char variant[GameRules::MAX_NAME_LENGTH];
+        unsigned char moves[MAX_ROUNDS / 4];
+        uint32_t checksum;
+    };
+    static_assert(sizeof(JournalRecord) == 88);
+
+    /**
+     * First slot of the journal, as big as a record. 'idBase' is the highest id in the archive when the journal
+     * was last emptied, so ids handed out by the journal never repeat ids which are in the archive already
+     */
+    struct JournalHeader {
+        static constexpr uint32_t MAGIC = 0x33484450; // "PDH3"
+
+        uint32_t magic;
+        uint32_t reserved;
+        int64_t idBase;
+        unsigned char unused[sizeof(JournalRecord) - 20];
+        uint32_t checksum;
+    };
+    static_assert(sizeof(JournalHeader) == sizeof(JournalRecord));
+
+    constexpr std::array<uint32_t, 256> makeCrcTable() {
+        std::array<uint32_t, 256> table{};
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t crc = i;
+            for (int bit = 0; bit < 8; bit++) {
+                crc = crc & 1 ? 0xEDB88320u ^ crc >> 1 : crc >> 1;
+            }
+            table[i] = crc;
+        }
+        return table;
+    }
+    constexpr auto crcTable = makeCrcTable();
+
+    template <typename Record>
+    uint32_t checksumOf(const Record& record) {
+        const auto bytes = (const unsigned char*)(&record);
+        uint32_t crc = 0xFFFFFFFFu;
+        for (size_t i = 0; i < offsetof(Record, checksum); i++) {
+            crc = crcTable[(crc ^ bytes[i]) & 0xFF] ^ crc >> 8;
+        }
+        return ~crc;
+    }
+
+    bool isValid(const JournalRecord& record) {
+        return record.magic == JournalRecord::MAGIC && record.rounds <= MAX_ROUNDS && record.checksum == checksumOf(record);
+    }
+
+    bool isValid(const JournalHeader& header) {
+        return header.magic == JournalHeader::MAGIC && header.checksum == checksumOf(header);
+    }
+
+    JournalRecord toRecord(const Match& match) {
+        const MoveLog& moves = match.getMoves();
+        if (moves.getRounds() > MAX_ROUNDS) {
+            throw std::runtime_error("Journal can not store matches longer than " +
+                                     std::to_string(MAX_ROUNDS) + " rounds");
+        }
+        if (match.getVariant().size() > sizeof(JournalRecord::variant)) {
+            throw std::runtime_error("Journal can not store variant names longer than " +
+                                     std::to_string(sizeof(JournalRecord::variant)) + " characters");
+        }
+        JournalRecord record{};
+        record.magic = JournalRecord::MAGIC;
+        record.user1Id = match.getUser1Id();
+        record.user2Id = match.getUser2Id();
+        record.rounds = (uint16_t)moves.getRounds();
+        record.players = (uint8_t)match.getPlayers();
+        record.seed = match.getSeed();
+        record.score1 = match.getScore1();
+        record.score2 = match.getScore2();
+        match.getVariant().copy(record.variant, sizeof(record.variant));
+        std::memcpy(record.moves, moves.getBytes().data(), moves.getBytes().size());
+        record.checksum = checksumOf(record);
+        return record;
+    }
+
+    Match toMatch(const JournalRecord& record) {
+        MoveLog moves(std::vector<unsigned char>(record.moves, record.moves + (record.rounds + 3) / 4), record.rounds);
+        return {record.user1Id, record.score1, record.user2Id, record.score2, std::move(moves), record.seed,
+                std::string(record.variant, strnlen(record.variant, sizeof(record.variant))), record.players};
+    }
+
+    //Matches of the journal 'file' from 'offset' up to the first invalid record
+    std::vector<Match> readRecords(std::FILE* file, const long offset) {
+        std::vector<Match> matches;
+        std::fseek(file, offset, SEEK_SET);
+        JournalRecord record{};
+        while (std::fread(&record, sizeof(record), 1, file) == 1 && isValid(record)) {
+            matches.push_back(toMatch(record));
+        }
+        return matches;
+    }
+}
+
+/**
+ * Opens (or creates) the journal, rebuilds leaderboard totals from 'archive' and the journal
+ * and starts the thread which periodically syncs the journal to disk
+ */
+JournalMatchDAO::JournalMatchDAO(const std::string& journalPath, std::shared_ptr<UserDAO> userDao,
+                                 std::shared_ptr<SqliteMatchDAO> archive, const std::chrono::milliseconds syncInterval)
+    : journalPath(journalPath), userDao(std::move(userDao)), archive(std::move(archive)), syncInterval(syncInterval) {
+    if (this->archive) {
+        totals = this->archive->getScoreTotals();
+    }
+    openJournal();
+    if (std::filesystem::file_size(journalPath) < sizeof(JournalHeader)) {
+        //A new journal, or one whose creation was cut short before its header was complete
+        rewriteJournal({}, 0);
+    }
+    scanJournal();
+    startSync();
+}
+
+//stops the sync thread, syncs whatever is left and closes the journal
+JournalMatchDAO::~JournalMatchDAO() {
+    stopSync();
+    if (journal != nullptr) {
+        std::fflush(journal);
+        _commit(_fileno(journal));
+        std::fclose(journal);
+    }
+}
+
+void JournalMatchDAO::openJournal() {
+    journal = std::fopen(journalPath.c_str(), "ab+");
+    if (journal == nullptr) {
+        throw std::runtime_error("Could not open match journal " + journalPath);
+    }
+}
+
+/**
+ * Replaces the journal with a header holding 'newIdBase' followed by records of 'matches'. The new journal is
+ * written next to the old one and renamed over it, so a crash in the middle leaves the old journal as it was
+ */
+void JournalMatchDAO::rewriteJournal(const std::vector<Match>& matches, const int newIdBase) {
+    std::vector<JournalRecord> contents;
+    contents.reserve(matches.size());
+    for (const Match& match : matches) {
+        contents.push_back(toRecord(match));
+    }
+    JournalHeader header{};
+    header.magic = JournalHeader::MAGIC;
+    header.idBase = newIdBase;
+    header.checksum = checksumOf(header);
+
+    const std::string rewrittenPath = journalPath + ".rewriting";
+    std::FILE* rewritten = std::fopen(rewrittenPath.c_str(), "wb");
+    const bool written = rewritten != nullptr &&
+                         std::fwrite(&header, sizeof(header), 1, rewritten) == 1 &&
+                         std::fwrite(contents.data(), sizeof(JournalRecord), contents.size(), rewritten) == contents.size() &&
+                         std::fflush(rewritten) == 0 && _commit(_fileno(rewritten)) == 0;
+    if (rewritten != nullptr) {
+        std::fclose(rewritten);
+    }
+    if (!written) {
+        throw std::runtime_error("Could not rewrite match journal " + journalPath);
+    }
+
+    std::fclose(journal);
+    std::filesystem::rename(rewrittenPath, journalPath);
+    openJournal();
+}
+
+/**
+ * Reads the header and the records after it, stops at the first invalid record and cuts the journal there.
+ * Records whose ids are in 'archive' already were exported by an export which did not get to empty the journal,
+ * they are dropped from it instead of being counted twice. An empty journal moves 'idBase' up to the archive's
+ * highest id, so a new journal next to a filled archive does not hand out ids which are taken
+ */
+void JournalMatchDAO::scanJournal() {
+    JournalHeader header{};
+    std::fseek(journal, 0, SEEK_SET);
+    if (std::fread(&header, sizeof(header), 1, journal) != 1 || !isValid(header)) {
+        throw std::runtime_error("Match journal " + journalPath + " has no valid header");
+    }
+    idBase = (int)header.idBase;
+    const int exported = archive ? std::max(archive->getMaxId() - idBase, 0) : 0;
+
+    JournalRecord record{};
+    while (std::fread(&record, sizeof(record), 1, journal) == 1 && isValid(record)) {
+        if (++records > exported) {
+            addToTotals(toMatch(record));
+        }
+    }
+
+    const auto validSize = (uintmax_t)(records + 1) * sizeof(JournalRecord);
+    if (std::filesystem::file_size(journalPath) != validSize) {
+        std::fclose(journal);
+        std::filesystem::resize_file(journalPath, validSize);
+        openJournal();
+    }
+
+    if (exported > 0) {
+        const long kept = (long)(std::min(exported, records) + 1) * (long)sizeof(JournalRecord);
+        rewriteJournal(readRecords(journal, kept), idBase + exported);
+        idBase += exported;
+        records = std::max(records - exported, 0);
+    }
+}
+
+//Starts the sync thread, called with 'journalMutex' held or before the thread ever ran
+void JournalMatchDAO::startSync() {
+    stopping = false;
+    syncThread = std::thread(&JournalMatchDAO::syncLoop, this);
+}
+
+//Joins the sync thread, the journal may be closed afterwards since no sync can be running on it anymore
+void JournalMatchDAO::stopSync() {
+    {
+        std::lock_guard<std::mutex> lock(journalMutex);
+        stopping = true;
+    }
+    cvSync.notify_all();
+    if (syncThread.joinable()) {
+        syncThread.join();
+    }
+}
+
+/**
+ * Syncs the journal to disk every 'syncInterval' if anything was appended since the last sync.
+ * The sync itself runs without 'journalMutex', so appends and reads do not wait for the disk
+ */
+void JournalMatchDAO::syncLoop() {
+    std::unique_lock<std::mutex> lock(journalMutex);
+    while (!stopping) {
+        cvSync.wait_for(lock, syncInterval, [&]() { return stopping; });
+        if (std::exchange(unsynced, false)) {
+            const int descriptor = _fileno(journal);
+            lock.unlock();
+            _commit(descriptor);
+            lock.lock();
+        }
+    }
+}
+
+void JournalMatchDAO::addToTotals(const Match& match) const {
+    auto& [sum1, count1] = totals[match.getUser1Id()];
+    sum1 += match.getScore1();
+    count1++;
+    auto& [sum2, count2] = totals[match.getUser2Id()];
+    sum2 += match.getScore2();
+    count2++;
+}
+
+//Appends certain match to the journal and returns its id, 'idBase' plus its position in the journal
+int JournalMatchDAO::addMatch(const Match& match) const {
+    const JournalRecord record = toRecord(match);
+
+    std::lock_guard<std::mutex> lock(journalMutex);
+    //The stream may have been read last ('readMatch'), a write must not follow a read without repositioning
+    std::fseek(journal, 0, SEEK_END);
+    if (std::fwrite(&record, sizeof(record), 1, journal) != 1 || std::fflush(journal) != 0) {
+        throw std::runtime_error("Failed to append match to " + journalPath);
+    }
+    unsynced = true;
+    addToTotals(match);
+    return idBase + ++records;
+}
+
+/**
+ * Decodes the match with id 'matchId', std::nullopt if the journal has no such match
+ * (including matches which were exported already, those are in the archive under the same id)
+ */
+std::optional<Match> JournalMatchDAO::readMatch(const int matchId) const {
+    std::lock_guard<std::mutex> lock(journalMutex);
+    const int position = matchId - idBase;
+    if (position < 1 || position > records) {
+        return std::nullopt;
+    }
+
+    JournalRecord record{};
+    std::fseek(journal, (long)position * (long)sizeof(JournalRecord), SEEK_SET);
+    if (std::fread(&record, sizeof(record), 1, journal) != 1 || !isValid(record)) {
+        throw std::runtime_error("Corrupted match journal " + journalPath);
+    }
+    return toMatch(record);
+}
+
+/**
+ * Decodes moves of the match with id 'matchId'.
+ * Returns empty MoveLog if there is no such match
+ */
+MoveLog JournalMatchDAO::getMoveLog(const int matchId) const {
+    if (const auto match = readMatch(matchId)) {
+        return match->getMoves();
+    }
+    return archive ? archive->getMoveLog(matchId) : MoveLog();
+}
+
+//Returns seed of the game the match with id 'matchId' was played in, 0 if it is unknown
+uint64_t JournalMatchDAO::getSeed(const int matchId) const {
+    if (const auto match = readMatch(matchId)) {
+        return match->getSeed();
+    }
+    return archive ? archive->getSeed(matchId) : 0;
+}
+
+//Returns variant and table size of the game the match with id 'matchId' was played in, {"", 0} if they are unknown
+std::pair<std::string, int> JournalMatchDAO::getVariant(const int matchId) const {
+    if (const auto match = readMatch(matchId)) {
+        return {match->getVariant(), match->getPlayers()};
+    }
+    return archive ? archive->getVariant(matchId) : std::make_pair(std::string(), 0);
+}
+
+//Returns the average scores both players of the match with id 'matchId' were stored with, {0, 0} if there is no such match
+std::pair<double, double> JournalMatchDAO::getScores(const int matchId) const {
+    if (const auto match = readMatch(matchId)) {
+        return {match->getScore1(), match->getScore2()};
+    }
+    return archive ? archive->getScores(matchId) : std::make_pair(0.0, 0.0);
+}
+
+//This function returns username and average of all scores of the user with id 'userId'
+std::pair<std::string, double> JournalMatchDAO::getAverageScore(const int userId) const {
+    double avgScore = 0.0;
+    {
+        std::lock_guard<std::mutex> lock(journalMutex);
+        if (const auto it = totals.find(userId); it != totals.end()) {
+            avgScore = it->second.first / it->second.second;
+        }
+    }
+    return std::make_pair(userDao->getUserById(userId).getUsername(), avgScore);
+}
+
+//This function returns top 'num' players
+std::vector<std::pair<std::string, double>> JournalMatchDAO::getTopPlayers(const int num) const {
+    std::vector<std::pair<int, double>> averages;
+    {
+        std::lock_guard<std::mutex> lock(journalMutex);
+        averages.reserve(totals.size());
+        for (const auto& [userId, total] : totals) {
+            averages.emplace_back(userId, total.first / total.second);
+        }
+    }
+
+    const auto top = averages.begin() + std::min((size_t)std::max(num, 0), averages.size());
+    std::partial_sort(averages.begin(), top, averages.end(),
+        [](const auto& a, const auto& b) { return a.second > b.second; });
+
+    std::vector<std::pair<std::string, double>> topPlayers;
+    for (auto it = averages.begin(); it != top; ++it) {
+        topPlayers.emplace_back(userDao->getUserById(it->first).getUsername(), it->second);
+    }
+    return topPlayers;
+}
+
+/**
+ * Moves every journaled match into 'archive' inside a single transaction and empties the journal.
+ * The matches keep their ids in the archive and 'idBase' moves past them, so the ids of later matches keep counting
+ * from where they were. Exporting twice stores nothing twice, which makes a crash before the journal was emptied
+ * harmless (see 'scanJournal'). Meant to be run offline (see '--export-journal' in main).
+ * Returns the number of exported matches
+ */
+int JournalMatchDAO::exportToArchive() {
+    if (!archive) {
+        throw std::runtime_error("Match journal has no archive to export into");
+    }
+
+    //The journal is closed and reopened below, no sync may be running on it meanwhile
+    stopSync();
+    std::lock_guard<std::mutex> lock(journalMutex);
+    try {
+        const std::vector<Match> matches = readRecords(journal, sizeof(JournalHeader));
+
+        archive->addMatches(matches, idBase + 1);
+
+        rewriteJournal({}, idBase + records);
+        idBase += records;
+        records = 0;
+        unsynced = false;
+        startSync();
+        return (int)matches.size();
+    } catch (...) {
+        startSync();
+        throw;
+    }
+}
@@ -1,21 +1,39 @@
 #include "Match.h"
 #include <utility>
 
-Match::Match(std::string user1, const double score1, std::string user2, const double score2)
-    : user1(std::move(user1)), score1(score1), user2(std::move(user2)), score2(score2) {}
+Match::Match(const int user1Id, const double score1, const int user2Id, const double score2, MoveLog moves,
+             const uint64_t seed, std::string variant, const int players)
+    : user1Id(user1Id), score1(score1), user2Id(user2Id), score2(score2), moves(std::move(moves)), seed(seed),
+      variant(std::move(variant)), players(players) {}
 
-std::string Match::getUser1() const {
-    return user1;
+int Match::getUser1Id() const {
+    return user1Id;
 }
 
 double Match::getScore1() const {
     return score1;
 }
 
-std::string Match::getUser2() const {
-    return user2;
+int Match::getUser2Id() const {
+    return user2Id;
 }
 
 double Match::getScore2() const {
     return score2;
 }
+
+const MoveLog& Match::getMoves() const {
+    return moves;
+}
+
+uint64_t Match::getSeed() const {
+    return seed;
+}
+
+const std::string& Match::getVariant() const {
+    return variant;
+}
+
+int Match::getPlayers() const {
+    return players;
+}
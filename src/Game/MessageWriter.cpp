@@ -0,0 +1,103 @@
+#include "MessageWriter.h"
+
+#include <charconv>
+
+//Starts a new message, text of the previous one is forgotten but its memory is kept
+void MessageWriter::begin(const std::string_view tag) {
+    this->tag = tag;
+    lineStart = true;
+    pieces.clear();
+    buffer.clear();
+}
+
+void MessageWriter::push(const char* data, const size_t offset, const size_t size) {
+    if (size > 0) {
+        pieces.push_back({data, offset, size});
+    }
+}
+
+//Adds 'text' by reference, with a tag every line of it is split off so the tag can go in front
+MessageWriter& MessageWriter::add(const std::string_view text) {
+    if (tag.empty()) {
+        push(text.data(), 0, text.size());
+        return *this;
+    }
+    for (size_t start = 0; start < text.size();) {
+        if (lineStart) {
+            push(tag.data(), 0, tag.size());
+        }
+        const size_t newline = text.find('\n', start);
+        const size_t end = newline == std::string_view::npos ? text.size() : newline + 1;
+        push(text.data() + start, 0, end - start);
+        lineStart = newline != std::string_view::npos;
+        start = end;
+    }
+    return *this;
+}
+
+//Copies 'size' formatted bytes into the writer's own buffer, 'text' never holds a newline
+void MessageWriter::addFormatted(const char* text, const size_t size) {
+    if (lineStart) {
+        push(tag.data(), 0, tag.size());
+        lineStart = false;
+    }
+    push(nullptr, buffer.size(), size);
+    buffer.append(text, size);
+}
+
+MessageWriter& MessageWriter::add(const int value) {
+    char digits[16];
+    const auto [end, error] = std::to_chars(digits, digits + sizeof(digits), value);
+    addFormatted(digits, end - digits);
+    return *this;
+}
+
+//Formats 'value' with six decimals, the same text std::to_string gives
+MessageWriter& MessageWriter::add(const double value) {
+    char digits[64];
+    if (const auto [end, error] = std::to_chars(digits, digits + sizeof(digits), value, std::chars_format::fixed, 6);
+        error == std::errc()) {
+        addFormatted(digits, end - digits);
+    } else {
+        const std::string text = std::to_string(value);
+        addFormatted(text.data(), text.size());
+    }
+    return *this;
+}
+
+//A tagged message always ends with a newline, so the next message starts on a line of its own
+void MessageWriter::finish() {
+    if (!tag.empty() && !lineStart) {
+        push("\n", 0, 1);
+        lineStart = true;
+    }
+}
+
+/**
+ * Posts the whole message to 'outbox' as all of its pieces, which goes out in one WSASend when nothing is pending.
+ * Returns false if the message was dropped (the reading side notices a broken connection on its own)
+ */
+bool MessageWriter::sendTo(Outbox& outbox) {
+    finish();
+    if (pieces.empty()) {
+        return true;
+    }
+    gather.clear();
+    for (const Piece& piece : pieces) {
+        WSABUF part;
+        part.len = (decltype(part.len))piece.size;
+        part.buf = (char*)(piece.data ? piece.data : buffer.data() + piece.offset);
+        gather.push_back(part);
+    }
+    return outbox.post(gather.data(), gather.size());
+}
+
+//The message as one string, for the few places which need to keep it (e.g. Broadcast)
+std::string MessageWriter::str() {
+    finish();
+    std::string text;
+    for (const Piece& piece : pieces) {
+        text.append(piece.data ? piece.data : buffer.data() + piece.offset, piece.size);
+    }
+    return text;
+}
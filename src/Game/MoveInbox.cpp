@@ -0,0 +1,98 @@
+#include "MoveInbox.h"
+
+MoveInbox::MoveInbox(const bool tagged) : tagged(tagged) {
+    if (!tagged) {
+        moves[ANY_GAME];
+    }
+}
+
+/**
+ * Starts accepting moves for 'gameId', called as soon as the client is seated in that game.
+ * 'onMove' is called (without the inbox locked) whenever a move for the game arrives or the client disconnects.
+ * Untagged moves left over from an earlier game are dropped, they were not meant for this one
+ */
+void MoveInbox::open(const int gameId, std::function<void()> onMove) {
+    std::lock_guard<std::mutex> lock(mutex);
+    moves[gameId];
+    listeners[gameId] = std::move(onMove);
+    if (!tagged) {
+        moves[ANY_GAME].clear();
+    }
+}
+
+//Drops what is left for 'gameId' once the game is over
+void MoveInbox::release(const int gameId) {
+    std::lock_guard<std::mutex> lock(mutex);
+    moves.erase(gameId);
+    listeners.erase(gameId);
+}
+
+//Listeners to call when a move for 'gameId' arrives, every game of the client for an untagged move
+std::vector<std::function<void()>> MoveInbox::listenersOf(const int gameId) const {
+    std::vector<std::function<void()>> found;
+    for (const auto& [id, listener] : listeners) {
+        if ((gameId == ANY_GAME || id == gameId) && listener) {
+            found.push_back(listener);
+        }
+    }
+    return found;
+}
+
+//Queues 'move' for the game 'gameId' ('ANY_GAME' if the client did not say) and wakes the game waiting for it
+void MoveInbox::deliver(const int gameId, const Move move) {
+    std::vector<std::function<void()>> wake;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        const auto found = moves.find(gameId);
+        if (found == moves.end() || found->second.size() >= MAX_PENDING) {
+            return;
+        }
+        found->second.push_back(move);
+        wake = listenersOf(gameId);
+    }
+    for (const auto& listener : wake) {
+        listener();
+    }
+}
+
+/**
+ * Next move meant for 'gameId' if it already arrived, SPLIT once the client disconnected,
+ * std::nullopt if the game has to wait for the move
+ */
+std::optional<Move> MoveInbox::poll(const int gameId) {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const int id : {gameId, ANY_GAME}) {
+        if (auto found = moves.find(id); found != moves.end() && !found->second.empty()) {
+            const Move move = found->second.front();
+            found->second.pop_front();
+            return move;
+        }
+    }
+    if (closed) {
+        return Move::SPLIT;
+    }
+    return std::nullopt;
+}
+
+//Called when the connection is gone, games still waiting for a move of this client stop waiting
+void MoveInbox::close() {
+    std::vector<std::function<void()>> wake;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        closed = true;
+        wake = listenersOf(ANY_GAME);
+    }
+    for (const auto& listener : wake) {
+        listener();
+    }
+}
+
+bool MoveInbox::isTagged() const {
+    return tagged;
+}
+
+//Whether a game opened this inbox and has not released it yet
+bool MoveInbox::isPlaying() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return !listeners.empty();
+}
@@ -0,0 +1,38 @@
+#include "MoveLog.h"
+#include <stdexcept>
+#include <string>
+
+//decodes 'bytes' previously produced by 'record()', throws if 'bytes' is too short for 'rounds' rounds
+MoveLog::MoveLog(std::vector<unsigned char> bytes, const int rounds)
+    : bytes(std::move(bytes)), rounds(rounds) {
+    if (rounds < 0 || this->bytes.size() * 4 < (size_t)rounds) {
+        throw std::runtime_error("Move log is shorter than " + std::to_string(rounds) + " rounds");
+    }
+}
+
+//appends moves of both players for the next round
+void MoveLog::record(const Move move1, const Move move2) {
+    if (rounds % 4 == 0) {
+        bytes.push_back(0);
+    }
+    const int shift = (rounds % 4) * 2;
+    bytes.back() |= (unsigned char)(((unsigned)move1 | (unsigned)move2 << 1) << shift);
+    rounds++;
+}
+
+int MoveLog::getRounds() const {
+    return rounds;
+}
+
+//returns moves of player1 and player2 in 'round' (0-based)
+std::pair<Move, Move> MoveLog::getRound(const int round) const {
+    if (round < 0 || round >= rounds) {
+        throw std::out_of_range("Round " + std::to_string(round) + " is not in the move log");
+    }
+    const unsigned bits = bytes[round / 4] >> ((round % 4) * 2);
+    return {(Move)(bits & 1), (Move)(bits >> 1 & 1)};
+}
+
+const std::vector<unsigned char>& MoveLog::getBytes() const {
+    return bytes;
+}
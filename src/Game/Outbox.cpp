@@ -0,0 +1,93 @@
+#include "Outbox.h"
+
+Outbox::Outbox(const SOCKET socket) : socket(socket) {}
+
+//Switches the socket to non-blocking mode and writes what was posted before, from now on games may write to it
+void Outbox::attach() {
+    std::lock_guard<std::mutex> lock(mutex);
+    u_long nonBlocking = 1;
+    ioctlsocket(socket, FIONBIO, &nonBlocking);
+    write();
+}
+
+//Puts the socket back to blocking mode and writes everything still pending, called once the client's games are over
+void Outbox::detach() {
+    std::lock_guard<std::mutex> lock(mutex);
+    u_long nonBlocking = 0;
+    ioctlsocket(socket, FIONBIO, &nonBlocking);
+    write();
+}
+
+bool Outbox::post(const std::string_view message) {
+    WSABUF piece;
+    piece.len = (decltype(piece.len))message.size();
+    piece.buf = (char*)message.data();
+    return post(&piece, 1);
+}
+
+/**
+ * Queues one message given as 'count' pieces (see MessageWriter). With nothing pending it goes out in one gather send
+ * right away and only what the socket did not take is copied.
+ * Returns false if the message was dropped: the outbox is closed, the connection failed or the client fell too far behind
+ */
+bool Outbox::post(const WSABUF* pieces, const size_t count) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (closed) {
+        return false;
+    }
+    size_t sent = 0;
+    if (pending.empty()) {
+        DWORD written = 0;
+        if (WSASend(socket, (WSABUF*)pieces, (DWORD)count, &written, 0, nullptr, nullptr) == 0) {
+            sent = written;
+        } else if (WSAGetLastError() != WSAEWOULDBLOCK) {
+            return false;
+        }
+    }
+    for (size_t i = 0; i < count; i++) {
+        if (sent >= pieces[i].len) {
+            sent -= pieces[i].len;
+            continue;
+        }
+        pending.append(pieces[i].buf + sent, pieces[i].len - sent);
+        sent = 0;
+    }
+    if (pending.size() > MAX_PENDING) {
+        closed = true;
+        pending.clear();
+        shutdown(socket, SD_BOTH);
+        return false;
+    }
+    return true;
+}
+
+//Writes what is pending, returns true if something is still left
+bool Outbox::flush() {
+    std::lock_guard<std::mutex> lock(mutex);
+    write();
+    return !pending.empty();
+}
+
+//Drops everything pending and every later message, for a connection which is going away
+void Outbox::close() {
+    std::lock_guard<std::mutex> lock(mutex);
+    closed = true;
+    pending.clear();
+}
+
+/**
+ * Writes pending bytes until the socket would block. A failing socket loses them,
+ * the connection's thread notices the broken connection when reading it
+ */
+void Outbox::write() {
+    while (!pending.empty()) {
+        const int sent = send(socket, pending.data(), (int)pending.size(), 0);
+        if (sent == SOCKET_ERROR) {
+            if (WSAGetLastError() != WSAEWOULDBLOCK) {
+                pending.clear();
+            }
+            return;
+        }
+        pending.erase(0, sent);
+    }
+}
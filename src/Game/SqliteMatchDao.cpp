@@ -0,0 +1,242 @@
+#include "SqliteMatchDao.h"
+
+#include <stdexcept>
+
+namespace {
+    const std::string createTableSQL = "CREATE TABLE IF NOT EXISTS Matches ("
+                                       "id INTEGER PRIMARY KEY AUTOINCREMENT, "
+                                       "User1Id INTEGER NOT NULL REFERENCES Users(Id), "
+                                       "Score1 REAL NOT NULL, "
+                                       "User2Id INTEGER NOT NULL REFERENCES Users(Id), "
+                                       "Score2 REAL NOT NULL, "
+                                       "Rounds INTEGER NOT NULL DEFAULT 0, "
+                                       "Moves BLOB, "
+                                       "Seed INTEGER NOT NULL DEFAULT 0, "
+                                       "Variant TEXT NOT NULL DEFAULT '', "
+                                       "Players INTEGER NOT NULL DEFAULT 0"
+                                       ");"
+                                       "CREATE INDEX IF NOT EXISTS MatchesUser1 ON Matches(User1Id);"
+                                       "CREATE INDEX IF NOT EXISTS MatchesUser2 ON Matches(User2Id);";
+}
+
+/**
+ * Makes sure 'Matches' table references users by their integer ids.
+ * Databases which still store usernames in 'User1'/'User2' are migrated in place,
+ * rows whose usernames are unknown to 'Users' table are dropped during the migration.
+ * Tables created before move logs existed get empty 'Rounds'/'Moves' columns, tables created before
+ * seeds were kept get 'Seed' 0 and tables created before variants were kept get 'Variant' "" and 'Players' 0.
+ * Expects 'Users' table to be already created (see SqliteUserDAO)
+ */
+SqliteMatchDAO::SqliteMatchDAO(std::shared_ptr<Database> database)
+    : database(std::move(database))
+{
+    auto connection = this->database->writer();
+    if (connection.hasColumn("Matches", "User1") && !connection.hasColumn("Matches", "User1Id")) {
+        connection.execTransaction("ALTER TABLE Matches RENAME TO MatchesLegacy;" +
+                                   createTableSQL +
+                                   "INSERT INTO Matches (id, User1Id, Score1, User2Id, Score2) "
+                                   "SELECT m.id, u1.Id, m.Score1, u2.Id, m.Score2 FROM MatchesLegacy m "
+                                   "JOIN Users u1 ON u1.Username = m.User1 "
+                                   "JOIN Users u2 ON u2.Username = m.User2;"
+                                   "DROP TABLE MatchesLegacy;", "Matches migration: ");
+    }
+
+    if (connection.hasColumn("Matches", "User1Id") && !connection.hasColumn("Matches", "Moves")) {
+        connection.execTransaction("ALTER TABLE Matches ADD COLUMN Rounds INTEGER NOT NULL DEFAULT 0;"
+                                   "ALTER TABLE Matches ADD COLUMN Moves BLOB;", "Matches migration: ");
+    }
+
+    if (connection.hasColumn("Matches", "Moves") && !connection.hasColumn("Matches", "Seed")) {
+        connection.exec("ALTER TABLE Matches ADD COLUMN Seed INTEGER NOT NULL DEFAULT 0;", "Matches migration: ");
+    }
+
+    if (connection.hasColumn("Matches", "Seed") && !connection.hasColumn("Matches", "Variant")) {
+        connection.execTransaction("ALTER TABLE Matches ADD COLUMN Variant TEXT NOT NULL DEFAULT '';"
+                                   "ALTER TABLE Matches ADD COLUMN Players INTEGER NOT NULL DEFAULT 0;",
+                                   "Matches migration: ");
+    }
+
+    connection.exec(createTableSQL, "Matches: ");
+}
+
+/**
+ * Inserts 'match' using already borrowed writer 'connection' and returns id of its row.
+ * With 'id' 0 the match gets a new id, otherwise it keeps 'id' and is skipped if a row with that id exists already
+ */
+int SqliteMatchDAO::insertMatch(Database::Connection& connection, const Match& match, const int id) {
+    sqlite3_stmt* stmt = connection.prepare(std::string(id == 0 ? "INSERT" : "INSERT OR IGNORE") +
+                                            " INTO Matches (id, User1Id, Score1, User2Id, Score2, Rounds, Moves, Seed, "
+                                            "Variant, Players) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?);");
+    if (id == 0) {
+        sqlite3_bind_null(stmt, 1);
+    } else {
+        sqlite3_bind_int(stmt, 1, id);
+    }
+    sqlite3_bind_int(stmt, 2, match.getUser1Id());
+    sqlite3_bind_double(stmt, 3, match.getScore1());
+    sqlite3_bind_int(stmt, 4, match.getUser2Id());
+    sqlite3_bind_double(stmt, 5, match.getScore2());
+    const MoveLog& moves = match.getMoves();
+    sqlite3_bind_int(stmt, 6, moves.getRounds());
+    sqlite3_bind_blob(stmt, 7, moves.getBytes().data(), (int)moves.getBytes().size(), SQLITE_STATIC);
+    //SQLite integers are signed, the seed is stored with the same 64 bits and cast back in 'getSeed'
+    sqlite3_bind_int64(stmt, 8, (sqlite3_int64)match.getSeed());
+    sqlite3_bind_text(stmt, 9, match.getVariant().c_str(), (int)match.getVariant().size(), SQLITE_STATIC);
+    sqlite3_bind_int(stmt, 10, match.getPlayers());
+
+    if (connection.step(stmt) != SQLITE_DONE) {
+        std::string error = "Failed to add match: ";
+        error += sqlite3_errmsg(connection.get());
+        throw std::runtime_error(error);
+    }
+    return id == 0 ? (int)sqlite3_last_insert_rowid(connection.get()) : id;
+}
+
+//Adds certain match together with its packed move log to the database and returns id of the new row
+int SqliteMatchDAO::addMatch(const Match &match) const {
+    auto connection = database->writer();
+    return insertMatch(connection, match, 0);
+}
+
+/**
+ * Adds all 'matches' inside a single transaction, which is much cheaper than calling 'addMatch' for each of them.
+ * The matches keep ids counting up from 'firstId', a match whose id is taken already is skipped,
+ * so adding the same matches again changes nothing. Either all matches are stored or, on failure, none of them
+ */
+void SqliteMatchDAO::addMatches(const std::vector<Match>& matches, const int firstId) const {
+    auto connection = database->writer();
+    connection.exec("BEGIN;", "Matches: ");
+    try {
+        for (size_t i = 0; i < matches.size(); i++) {
+            insertMatch(connection, matches[i], firstId + (int)i);
+        }
+    } catch (...) {
+        sqlite3_exec(connection.get(), "ROLLBACK;", nullptr, nullptr, nullptr);
+        throw;
+    }
+    connection.exec("COMMIT;", "Matches: ");
+}
+
+//Returns the highest id of a stored match, 0 if there are none
+int SqliteMatchDAO::getMaxId() const {
+    auto connection = database->reader();
+    sqlite3_stmt* stmt = connection.prepare("SELECT COALESCE(MAX(id), 0) FROM Matches;");
+    return connection.step(stmt) == SQLITE_ROW ? sqlite3_column_int(stmt, 0) : 0;
+}
+
+/**
+ * Decodes moves of the match with id 'matchId'.
+ * Returns empty MoveLog if the match does not exist or was stored without moves
+ */
+MoveLog SqliteMatchDAO::getMoveLog(const int matchId) const {
+    auto connection = database->reader();
+    sqlite3_stmt* stmt = connection.prepare("SELECT Rounds, Moves FROM Matches WHERE id = ?;");
+    sqlite3_bind_int(stmt, 1, matchId);
+
+    if (connection.step(stmt) == SQLITE_ROW) {
+        const auto data = (const unsigned char*)(sqlite3_column_blob(stmt, 1));
+        const int size = sqlite3_column_bytes(stmt, 1);
+        std::vector<unsigned char> bytes(data, data + size);
+        return {std::move(bytes), sqlite3_column_int(stmt, 0)};
+    }
+    return {};
+}
+
+//Returns seed of the game the match with id 'matchId' was played in, 0 if it is unknown
+uint64_t SqliteMatchDAO::getSeed(const int matchId) const {
+    auto connection = database->reader();
+    sqlite3_stmt* stmt = connection.prepare("SELECT Seed FROM Matches WHERE id = ?;");
+    sqlite3_bind_int(stmt, 1, matchId);
+
+    if (connection.step(stmt) == SQLITE_ROW) {
+        return (uint64_t)sqlite3_column_int64(stmt, 0);
+    }
+    return 0;
+}
+
+//Returns variant and table size of the game the match with id 'matchId' was played in, {"", 0} if they are unknown
+std::pair<std::string, int> SqliteMatchDAO::getVariant(const int matchId) const {
+    auto connection = database->reader();
+    sqlite3_stmt* stmt = connection.prepare("SELECT Variant, Players FROM Matches WHERE id = ?;");
+    sqlite3_bind_int(stmt, 1, matchId);
+
+    if (connection.step(stmt) == SQLITE_ROW) {
+        return {(const char*)(sqlite3_column_text(stmt, 0)), sqlite3_column_int(stmt, 1)};
+    }
+    return {};
+}
+
+//Returns the average scores both players of the match with id 'matchId' were stored with, {0, 0} if there is no such match
+std::pair<double, double> SqliteMatchDAO::getScores(const int matchId) const {
+    auto connection = database->reader();
+    sqlite3_stmt* stmt = connection.prepare("SELECT Score1, Score2 FROM Matches WHERE id = ?;");
+    sqlite3_bind_int(stmt, 1, matchId);
+
+    if (connection.step(stmt) == SQLITE_ROW) {
+        return {sqlite3_column_double(stmt, 0), sqlite3_column_double(stmt, 1)};
+    }
+    return {};
+}
+
+//This function returns username and average of all scores of the user with id 'userId'
+std::pair<std::string, double> SqliteMatchDAO::getAverageScore(const int userId) const {
+    auto connection = database->reader();
+    sqlite3_stmt* stmt = connection.prepare("SELECT Username, "
+                                            "(SELECT AVG(score) FROM ("
+                                            "SELECT Score1 AS score FROM Matches WHERE User1Id = Users.Id "
+                                            "UNION ALL "
+                                            "SELECT Score2 AS score FROM Matches WHERE User2Id = Users.Id"
+                                            ")) AS avg_score "
+                                            "FROM Users "
+                                            "WHERE Id = ?;");
+    sqlite3_bind_int(stmt, 1, userId);
+
+    std::string username;
+    double avgScore = 0.0;
+    if (connection.step(stmt) == SQLITE_ROW) {
+        username = (const char*)(sqlite3_column_text(stmt, 0));
+        avgScore = sqlite3_column_double(stmt, 1);
+    }
+    return std::make_pair(username, avgScore);
+}
+
+//This function returns top 'num' players
+std::vector<std::pair<std::string, double>> SqliteMatchDAO::getTopPlayers(const int num) const {
+    auto connection = database->reader();
+    sqlite3_stmt* stmt = connection.prepare("SELECT Users.Username, scores.avg_score "
+                                            "FROM ("
+                                            "SELECT userId, AVG(score) AS avg_score FROM ("
+                                            "SELECT User1Id AS userId, Score1 AS score FROM Matches "
+                                            "UNION ALL "
+                                            "SELECT User2Id AS userId, Score2 AS score FROM Matches"
+                                            ") GROUP BY userId"
+                                            ") AS scores "
+                                            "JOIN Users ON Users.Id = scores.userId "
+                                            "ORDER BY scores.avg_score DESC "
+                                            "LIMIT ?;");
+    sqlite3_bind_int(stmt, 1, num);
+
+    std::vector<std::pair<std::string, double>> topPlayers;
+    while (connection.step(stmt) == SQLITE_ROW) {
+        auto username = (const char*)(sqlite3_column_text(stmt, 0));
+        double avg_score = sqlite3_column_double(stmt, 1);
+        topPlayers.emplace_back(username, avg_score);
+    }
+    return topPlayers;
+}
+
+//This function returns sum and count of all scores for every user id which played at least once
+std::unordered_map<int, std::pair<double, int>> SqliteMatchDAO::getScoreTotals() const {
+    auto connection = database->reader();
+    sqlite3_stmt* stmt = connection.prepare("SELECT userId, SUM(score), COUNT(*) FROM ("
+                                            "SELECT User1Id AS userId, Score1 AS score FROM Matches "
+                                            "UNION ALL "
+                                            "SELECT User2Id AS userId, Score2 AS score FROM Matches"
+                                            ") GROUP BY userId;");
+
+    std::unordered_map<int, std::pair<double, int>> totals;
+    while (connection.step(stmt) == SQLITE_ROW) {
+        totals[sqlite3_column_int(stmt, 0)] = {sqlite3_column_double(stmt, 1), sqlite3_column_int(stmt, 2)};
+    }
+    return totals;
+}
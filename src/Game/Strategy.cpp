@@ -0,0 +1,73 @@
+#include "Strategy.h"
+
+Move TitForTat::next(const int round, Move, const Move opponentLast) {
+    return round == 0 ? Move::SPLIT : opponentLast;
+}
+
+void Grudger::reset(uint64_t) {
+    betrayed = false;
+}
+
+Move Grudger::next(const int round, Move, const Move opponentLast) {
+    betrayed |= round > 0 && opponentLast == Move::STEAL;
+    return betrayed ? Move::STEAL : Move::SPLIT;
+}
+
+//After a round where both made the same move the payoff was 3 or 1, Pavlov splits exactly after those
+Move Pavlov::next(const int round, const Move myLast, const Move opponentLast) {
+    return round == 0 || myLast == opponentLast ? Move::SPLIT : Move::STEAL;
+}
+
+void RandomStrategy::reset(const uint64_t seed) {
+    generator.seed(seed);
+}
+
+Move RandomStrategy::next(int, Move, Move) {
+    return (generator() >> 63) ? Move::STEAL : Move::SPLIT;
+}
+
+std::vector<std::unique_ptr<Strategy>> builtinStrategies() {
+    std::vector<std::unique_ptr<Strategy>> strategies;
+    strategies.push_back(std::make_unique<TitForTat>());
+    strategies.push_back(std::make_unique<Grudger>());
+    strategies.push_back(std::make_unique<Pavlov>());
+    strategies.push_back(std::make_unique<RandomStrategy>());
+    strategies.push_back(std::make_unique<AlwaysSplit>());
+    strategies.push_back(std::make_unique<AlwaysSteal>());
+    return strategies;
+}
+
+std::unique_ptr<Strategy> makeStrategy(const std::string& name) {
+    for (auto& strategy : builtinStrategies()) {
+        if (strategy->getName() == name) {
+            return std::move(strategy);
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * Resets both strategies (with different seeds derived from 'seed') and plays 'rounds' rounds,
+ * scoring every round with the same payoff table GameSession uses
+ */
+MatchScore playMatch(Strategy& first, Strategy& second, const int rounds, const uint64_t seed, MoveLog* log) {
+    first.reset(seed);
+    second.reset(seed ^ 0x9e3779b97f4a7c15ULL);
+
+    MatchScore score;
+    Move last1 = Move::SPLIT;
+    Move last2 = Move::SPLIT;
+    for (int round = 0; round < rounds; round++) {
+        const Move move1 = first.next(round, last1, last2);
+        const Move move2 = second.next(round, last2, last1);
+        const Payoff coins = payoff(move1, move2);
+        score.score1 += coins.first;
+        score.score2 += coins.second;
+        if (log) {
+            log->record(move1, move2);
+        }
+        last1 = move1;
+        last2 = move2;
+    }
+    return score;
+}
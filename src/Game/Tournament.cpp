@@ -0,0 +1,84 @@
+#include "Tournament.h"
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include "Random.h"
+
+namespace {
+    //Matches a thread takes from the schedule at once
+    constexpr long long BATCH = 256;
+}
+
+Tournament::Tournament(std::vector<std::unique_ptr<Strategy>> strategies, const int rounds,
+                       const int repetitions, const uint64_t seed)
+    : strategies(std::move(strategies)), rounds(rounds), repetitions(repetitions), seed(seed) {
+    for (int i = 0; i < (int)this->strategies.size(); i++) {
+        for (int j = i; j < (int)this->strategies.size(); j++) {
+            pairings.emplace_back(i, j);
+        }
+    }
+}
+
+long long Tournament::getMatchCount() const {
+    return (long long)pairings.size() * repetitions;
+}
+
+/**
+ * Plays the whole tournament and returns name of every strategy with its average coins per round,
+ * best strategy first (the same shape as MatchDAO::getTopPlayers, so it can be printed with makeTable)
+ */
+std::vector<std::pair<std::string, double>> Tournament::run(const int threads) const {
+    const size_t count = strategies.size();
+    std::vector<long long> coins(count, 0);
+    std::vector<long long> roundsPlayed(count, 0);
+    std::mutex totalsMutex;
+    std::atomic<long long> nextMatch{0};
+    const long long matchCount = getMatchCount();
+
+    auto worker = [&]() {
+        //Two copies of every strategy, so a strategy can play against itself
+        std::vector<std::unique_ptr<Strategy>> firsts;
+        std::vector<std::unique_ptr<Strategy>> seconds;
+        for (const auto& strategy : strategies) {
+            firsts.push_back(strategy->clone());
+            seconds.push_back(strategy->clone());
+        }
+        std::vector<long long> localCoins(count, 0);
+        std::vector<long long> localRounds(count, 0);
+
+        for (long long begin = nextMatch.fetch_add(BATCH); begin < matchCount; begin = nextMatch.fetch_add(BATCH)) {
+            for (long long match = begin; match < std::min(begin + BATCH, matchCount); match++) {
+                const auto [i, j] = pairings[match / repetitions];
+                const MatchScore score = playMatch(*firsts[i], *seconds[j], rounds, streamSeed(seed, match));
+                localCoins[i] += score.score1;
+                localCoins[j] += score.score2;
+                localRounds[i] += rounds;
+                localRounds[j] += rounds;
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(totalsMutex);
+        for (size_t k = 0; k < count; k++) {
+            coins[k] += localCoins[k];
+            roundsPlayed[k] += localRounds[k];
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (int t = 1; t < std::max(threads, 1); t++) {
+        workers.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : workers) {
+        thread.join();
+    }
+
+    std::vector<std::pair<std::string, double>> ranking;
+    for (size_t k = 0; k < count; k++) {
+        ranking.emplace_back(strategies[k]->getName(), roundsPlayed[k] ? (double)coins[k] / roundsPlayed[k] : 0.0);
+    }
+    std::ranges::stable_sort(ranking, [](const auto& a, const auto& b) { return a.second > b.second; });
+    return ranking;
+}
@@ -1,14 +1,35 @@
 #include "Server.h"
+#include <algorithm>
+#include <charconv>
 #include <iostream>
+#include <optional>
+#include <sstream>
 #include <utility>
 #include "HelperFunctions.h"
-#include "GameSession.h"
+#include "Broadcast.h"
+#include "Random.h"
 
 //starts initializing WinSock and setups 'listeningSocket'
 Server::Server(std::string  ip, const int port, std::shared_ptr<ServerAuthenticator> serverAuthenticator,
-                std::shared_ptr<MatchDAO> matchDAO)
+                std::shared_ptr<MatchDAO> matchDAO, std::vector<BotPlayer> bots, const std::chrono::milliseconds botWait,
+                const std::vector<GameRules>& variants, const TournamentSettings tournaments, const int gameThreads,
+                const uint64_t seed)
     : ip(std::move(ip)), port(port), listeningSocket(INVALID_SOCKET),
-        running(false), authenticator(std::move(serverAuthenticator)), matchDAO(std::move(matchDAO)) {
+        running(false), authenticator(std::move(serverAuthenticator)), matchmakingQueues(variants.size()), seed(seed),
+        matchDAO(std::move(matchDAO)), bots(std::move(bots)), botWait(botWait), tournaments(tournaments),
+        scheduler(gameThreads) {
+    if (variants.empty()) {
+        throw std::invalid_argument("Server needs at least one game variant");
+    }
+    for (const GameRules& rules : variants) {
+        this->variants.push_back(std::make_shared<const GameRules>(rules));
+        if (!tournamentRules && rules.getPlayers() == 2) {
+            tournamentRules = this->variants.back();
+        }
+    }
+    if (!tournamentRules) {
+        tournamentRules = std::make_shared<const GameRules>();
+    }
     initializeWinSock();
     setupListeningSocket();
 }
@@ -63,6 +84,7 @@ void Server::start() {
  * Changes state of 'running' ro false
  * Closes 'listeningSocket' if one is valid.
  * Cleans up WSA
+ * Stops the game scheduler
  * Joins every thread which is stored in clientThreads
  */
 void Server::stop() {
@@ -76,6 +98,7 @@ void Server::stop() {
     if (matchmakingThread.joinable()) {
         matchmakingThread.join();
     }
+    scheduler.stop();
     for (auto& t : clientThreads) {
         if (t.joinable()) {
             t.join();
@@ -99,95 +122,217 @@ void Server::acceptConnections() {
     }
 }
 
+/**
+ * Marks clients at 'table' as playing, opens their inboxes for the new game, tells them who their opponents are
+ * and hands the game to the scheduler. The game is listed for spectators until it ends.
+ * Game number n plays with seed streamSeed('seed', n) (see Random.h), so a server started with the same 'seed'
+ * and driven by the same scripted clients plays the same games again.
+ * 'onFinished' gets the scores of the seats once the game is over
+ */
+void Server::startGame(std::vector<Participant> table, const std::shared_ptr<const GameRules>& rules,
+                       std::function<void(const std::vector<int>&)> onFinished) {
+    const int gameId = nextGameId++;
+    {
+        std::lock_guard<std::mutex> lock(playingMutex);
+        for (const Participant& participant : table) {
+            if (!participant.bot) {
+                participant.inbox->open(gameId, [this, gameId]() { scheduler.wake(gameId); });
+            }
+        }
+    }
+    std::string title;
+    for (const Participant& participant : table) {
+        title += (title.empty() ? "" : " vs ") + participant.username.str();
+    }
+    const auto broadcast = std::make_shared<Broadcast>(title + " (" + rules->getName() + ")");
+    {
+        std::lock_guard<std::mutex> lock(broadcastsMutex);
+        std::erase_if(broadcasts, [](const auto& entry) { return entry.second->isClosed(); });
+        broadcasts[gameId] = broadcast;
+    }
+
+    for (size_t seat = 0; seat < table.size(); seat++) {
+        if (table[seat].binary) {
+            FrameWriter frame;
+            frame.begin(FrameType::GAME_START).put32(gameId).put8((uint8_t)seat).put8((uint8_t)table.size());
+            for (const Participant& player : table) {
+                frame.putString(player.username.str());
+            }
+            frame.sendTo(*table[seat].outbox);
+        }
+    }
+    for (const Participant& participant : table) {
+        std::string opponents;
+        for (const Participant& opponent : table) {
+            if (&opponent != &participant) {
+                opponents += (opponents.empty() ? "" : ", ") + opponent.username.str();
+            }
+        }
+        GameSession::send(participant, gameId, "Paired with " + opponents + "! Get Ready!\n");
+    }
+
+    auto gameSession = std::make_unique<GameSession>(gameId, std::move(table), playingMutex, cvPlaying,
+                                                     matchDAO, rules, broadcast, streamSeed(seed, gameId));
+    gameSession->setOnFinished(std::move(onFinished));
+    scheduler.add(gameId, std::move(gameSession));
+}
+
 /**
  * This is a single thread which is for pairing users which are in the queue.
- * It uses matchmakingQueue where all players who want to play are
+ * It uses matchmakingQueues where all players who want to play are, one queue per game variant
  * Everything is thread-saved using condition variable and mutex
  *
- * After pairing, starts a game between two of them
+ * Once a queue holds enough different users for a table of its variant, starts a game between them
+ * If there are bots, the client at the front of a queue who has waited 'botWait' without enough opponents
+ * gets the next bots on the empty seats instead, so nobody waits much longer than 'botWait'
  */
 void Server::matchmakingLoop() {
+    const auto seats = [&](const size_t variant) { return (size_t)variants[variant]->getPlayers(); };
+    const auto botDue = [&](const size_t variant) {
+        const std::deque<QueueEntry>& queue = matchmakingQueues[variant];
+        return !bots.empty() && !queue.empty() && countUsers(queue, seats(variant)) < seats(variant) &&
+               std::chrono::steady_clock::now() >= queue.front().queuedAt + botWait;
+    };
+    const auto ready = [&]() {
+        for (size_t variant = 0; variant < matchmakingQueues.size(); variant++) {
+            if (countUsers(matchmakingQueues[variant], seats(variant)) >= seats(variant) || botDue(variant)) {
+                return true;
+            }
+        }
+        return !running;
+    };
+    const auto seat = [](const QueueEntry& entry) {
+        return Participant{entry.username, entry.userId, entry.outbox, nullptr, entry.inbox, entry.binary};
+    };
+
     while (running) {
         std::unique_lock<std::mutex> lock(matchmakingMutex);
-        cvMatchMaking.wait(lock, [&]() { return matchmakingQueue.size() >= 2 || !running; });
-
-        while (running && matchmakingQueue.size() >= 2) {
-            const std::string player1 = matchmakingQueue.front().first;
-            const SOCKET client1Socket = matchmakingQueue.front().second;
-            matchmakingQueue.pop();
-            const std::string player2 = matchmakingQueue.front().first;
-            const SOCKET client2Socket = matchmakingQueue.front().second;
-            matchmakingQueue.pop();
-
-            sendToClient(client1Socket, "Paired with " + player2 + "! Get Ready!\n");
-            sendToClient(client2Socket, "Paired with " + player1 + "! Get Ready!\n");
-            std::this_thread::sleep_for(std::chrono::seconds(1));
+        //The next bot is due for whoever has been waiting the longest in any queue
+        std::optional<std::chrono::steady_clock::time_point> deadline;
+        for (const auto& queue : matchmakingQueues) {
+            if (!queue.empty() && (!deadline || queue.front().queuedAt + botWait < *deadline)) {
+                deadline = queue.front().queuedAt + botWait;
+            }
+        }
+        if (bots.empty()) {
+            cvMatchMaking.wait(lock, ready);
+        } else if (!deadline) {
+            cvMatchMaking.wait(lock, [&]() {
+                return !running || std::ranges::any_of(matchmakingQueues, [](const auto& queue) { return !queue.empty(); });
+            });
+        } else {
+            cvMatchMaking.wait_until(lock, *deadline, ready);
+        }
 
-            {
-                std::lock_guard<std::mutex> lock2(playingMutex);
-                playingUsers.insert(player1);
-                playingUsers.insert(player2);
+        for (size_t variant = 0; running && variant < matchmakingQueues.size(); variant++) {
+            std::deque<QueueEntry>& queue = matchmakingQueues[variant];
+            while (running && countUsers(queue, seats(variant)) >= seats(variant)) {
+                std::vector<Participant> table;
+                for (const QueueEntry& entry : takeTable(queue, seats(variant))) {
+                    table.push_back(seat(entry));
+                }
+                startGame(std::move(table), variants[variant]);
             }
-            GameSession gameSession(player1, client1Socket, player2, client2Socket,
-                playingMutex, cvPlaying, playingUsers, matchDaoMutex, matchDAO);
-            std::thread([gameSession]() mutable {
-                gameSession.runGame();
-            }).detach();
 
-            cvHandleClient.notify_all();
+            while (running && botDue(variant)) {
+                std::vector<Participant> table;
+                for (const QueueEntry& entry : takeTable(queue, seats(variant))) {
+                    table.push_back(seat(entry));
+                }
+                while (table.size() < seats(variant)) {
+                    const BotPlayer& bot = bots[nextBot++ % bots.size()];
+                    table.push_back({bot.username, bot.userId, nullptr, bot.strategy->clone(), nullptr});
+                }
+                startGame(std::move(table), variants[variant]);
+            }
         }
+        cvHandleClient.notify_all();
     }
 }
 
 /**
  * This is a main menu of the game. It asks user if one wants to play or exit
- * Once the player chooses to play, this method puts username and socket associated with them into queue
- * and notifies 'matchmakingLoop' that it should check the size of 'matchmakingQueue'
+ * Once the player chooses to play, this method puts username and socket associated with them into the queue
+ * of the chosen game variant ("P <variant>", plain "P" is the first one), once per game for "M <n> [variant]",
+ * and notifies 'matchmakingLoop' that it should check the size of 'matchmakingQueues'
  *
- * Waits up until the game is ended and only then goes back to the start of the loop
+ * Relays moves of the client up until all its games are ended and only then goes back to the start of the loop
  */
-void Server::mainMenuLoop(const SOCKET clientSocket, const std::string& username) {
-    const auto matchmakingTimeout = std::chrono::seconds(30);
+void Server::mainMenuLoop(const SOCKET clientSocket, const Username username, const int userId) {
+    std::string variantNames;
+    for (const auto& rules : variants) {
+        variantNames += (variantNames.empty() ? "" : ", ") + rules->getName();
+    }
     while(running) {
         std::string mainMenu;
-        {
-            std::unique_lock<std::mutex> lock(matchDaoMutex);
-            mainMenu += makeTable(matchDAO->getTopPlayers(5));
-            mainMenu += makeRow(matchDAO->getAverageScore(username));
-            mainMenu += border + "\n";
-            mainMenu += "play/exit (P/X): ";
-        }
+        mainMenu += makeTable(matchDAO->getTopPlayers(5));
+        mainMenu += makeRow(matchDAO->getAverageScore(userId));
+        mainMenu += border + "\n";
+        mainMenu += variants.size() == 1 ? "play/tournament/watch/exit (P/T/W/X): "
+                                         : "variants: " + variantNames +
+                                           "\nplay/tournament/watch/exit (P [variant]/T/W/X): ";
         std::vector<std::string> userInput = promptUser(clientSocket, {mainMenu});
         if (userInput.empty()) {
             break;
         }
-        if (userInput[0] == "P") {
-            {
-                std::lock_guard<std::mutex> lock(matchmakingMutex);
-                const std::pair pair(username, clientSocket);
-                matchmakingQueue.push(pair);
-            }
-            cvMatchMaking.notify_one();
-            {
-                std::unique_lock<std::mutex> lock(matchmakingMutex);
-                if (cvHandleClient.wait_for(lock, matchmakingTimeout,
-                    [&]() { return !findInQueue(username, matchmakingQueue) || !running; })) {
-                    if (!running) {
-                        return;
-                    }
-                } else {
-                    removeFromQueue(username, matchmakingQueue);
-                    sendToClient(clientSocket, "Matchmaking timeout. Try again.\n");
-                    std::this_thread::sleep_for(std::chrono::seconds(1));
-                    continue;
-                }
+        std::stringstream words(userInput[0]);
+        std::string command;
+        std::string variantName;
+        int games = 1;
+        words >> command;
+        if (command == "M" && !(words >> games)) {
+            games = 0;
+        }
+        words >> variantName;
+        if (command == "P" || command == "M") {
+            if (variantName.empty()) {
+                variantName = variants.front()->getName();
+            }
+            const auto found = std::ranges::find_if(variants, [&](const auto& rules) {
+                return rules->getName() == variantName;
+            });
+            if (found == variants.end() || games < 1 || games > MAX_GAMES_PER_CLIENT) {
+                sendToClient(clientSocket, found == variants.end()
+                                               ? "unknown game variant: " + variantName + "\n"
+                                               : "number of games must be within 1-" +
+                                                 std::to_string(MAX_GAMES_PER_CLIENT) + "\n");
+                std::this_thread::sleep_for(std::chrono::seconds(1));
+                continue;
+            }
+            const auto inbox = std::make_shared<MoveInbox>(command == "M");
+            const auto outbox = std::make_shared<Outbox>(clientSocket);
+            outbox->attach();
+            const auto [timedOut, seated] = joinQueue({username, userId, outbox, {}, inbox},
+                                                      found - variants.begin(), games);
+            if (!running) {
+                outbox->close();
+                return;
+            }
+            //A client waiting for several games plays those which found opponents before the timeout
+            if (timedOut) {
+                outbox->post("Matchmaking timeout. Try again.\n");
             }
-            {
-                std::unique_lock<std::mutex> lock(playingMutex);
-                cvPlaying.wait(lock, [&]() { return !playingUsers.contains(username) || !running;});
+            const auto playing = [&]() { return inbox->isPlaying(); };
+            if (!relayMoves(clientSocket, *inbox, *outbox, playing)) {
+                outbox->close();
+                waitForGames(*inbox);
+                return;
             }
+            outbox->detach();
             std::this_thread::sleep_for(std::chrono::seconds(1));
-        } else if (userInput[0] == "X") {
+        } else if (command == "T") {
+            if (!playTournament(clientSocket, username, userId)) {
+                return;
+            }
+        } else if (command == "W") {
+            int gameId = 0;
+            if (!(std::stringstream(variantName) >> gameId)) {
+                sendToClient(clientSocket, listGames());
+                std::this_thread::sleep_for(std::chrono::seconds(1));
+            } else if (!watchGame(clientSocket, gameId)) {
+                return;
+            }
+        } else if (command == "X") {
             const auto goodbye_message = "Goodbye!";
             sendToClient(clientSocket, goodbye_message);
             break;
@@ -200,22 +345,500 @@ void Server::mainMenuLoop(const SOCKET clientSocket, const std::string& username
 }
 
 /**
- * Starts with loginRegistrationPhase, if client logs in successfully, stores the username in 'activeUsers'
- * so while logged in, no other client can log in using the same account
+ * Puts 'games' entries of the client 'entry' describes into the matchmaking queue of 'variant' and notifies
+ * 'matchmakingLoop', then waits until all of them are seated or the matchmaking timeout passed.
+ * Returns whether it timed out and whether any game of the client is running now
  */
-void Server::handleClient(const SOCKET clientSocket) {
-    const std::string username = authenticator->loginRegistrationPhase(clientSocket, activeUsersMutex, activeUsers);
-    if (username.empty()) {
-        closesocket(clientSocket);
+std::pair<bool, bool> Server::joinQueue(QueueEntry entry, const size_t variant, const int games) {
+    const auto matchmakingTimeout = std::chrono::seconds(30);
+    std::deque<QueueEntry>& matchmakingQueue = matchmakingQueues[variant];
+    entry.queuedAt = std::chrono::steady_clock::now();
+    {
+        std::lock_guard<std::mutex> lock(matchmakingMutex);
+        for (int i = 0; i < games; i++) {
+            matchmakingQueue.push_back(entry);
+        }
+    }
+    cvMatchMaking.notify_one();
+    bool timedOut = false;
+    {
+        std::unique_lock<std::mutex> lock(matchmakingMutex);
+        if (!cvHandleClient.wait_for(lock, matchmakingTimeout,
+            [&]() { return !findInQueue(entry.username, matchmakingQueue) || !running; })) {
+            removeFromQueue(entry.username, matchmakingQueue);
+            timedOut = true;
+        }
+    }
+    return {timedOut, entry.inbox->isPlaying()};
+}
+
+/**
+ * Reads the connection while the client plays, every line is a move for the game it is tagged with
+ * ("#<gameId> STEAL") or for the only game of an untagged client. Anything but "STEAL" counts as SPLIT.
+ * Only lines ended by '\n' count, a line split over several reads waits in 'pending' until it is complete.
+ * Empty lines are skipped, a line longer than 'MAX_INPUT_LENGTH' is a SPLIT without being buffered.
+ * A binary client ('frames' given) sends MOVE frames instead, every other frame is handed to 'onRequest' at once,
+ * so the connection is read on and later MOVEs are never held up behind a request.
+ * Meanwhile it finishes writing what its games posted to 'outbox' but the socket could not take at once.
+ * Returns once 'keepRelaying' says the client is done (all its games are over), false if the client
+ * disconnected or broke the protocol meanwhile. Its inbox is closed then, so its games go on without waiting for it
+ */
+bool Server::relayMoves(const SOCKET clientSocket, MoveInbox& inbox, Outbox& outbox,
+                        const std::function<bool()>& keepRelaying, FrameReceiver* frames,
+                        const std::function<void(FrameReader&)>& onRequest) {
+    std::string pending;
+    bool overlong = false;
+    bool writing = outbox.flush();
+    while (running) {
+        if (!keepRelaying()) {
+            return true;
+        }
+        //Wakes up regularly to notice games which ended while the client stayed silent
+        fd_set readable;
+        fd_set writable;
+        FD_ZERO(&readable);
+        FD_ZERO(&writable);
+        FD_SET(clientSocket, &readable);
+        if (writing) {
+            FD_SET(clientSocket, &writable);
+        }
+        timeval timeout = {0, 200000};
+        const int ready = select((int)clientSocket + 1, &readable, &writable, nullptr, &timeout);
+        writing = outbox.flush();
+        if (ready <= 0 || !FD_ISSET(clientSocket, &readable)) {
+            continue;
+        }
+
+        const std::string received = receiveFromClient(clientSocket);
+        if (received.empty()) {
+            inbox.close();
+            return false;
+        }
+        if (frames) {
+            try {
+                frames->feed(received);
+                while (std::optional<FrameReader> frame = frames->next()) {
+                    if (frame->getType() != FrameType::MOVE) {
+                        onRequest(*frame);
+                        continue;
+                    }
+                    const int gameId = (int)frame->get32();
+                    inbox.deliver(gameId, frame->get8() == 1 ? Move::STEAL : Move::SPLIT);
+                }
+                writing = outbox.flush();
+            } catch (const std::runtime_error&) {
+                inbox.close();
+                return false;
+            }
+            continue;
+        }
+        pending += received;
+        size_t start = 0;
+        for (size_t newline; (newline = pending.find('\n', start)) != std::string::npos; start = newline + 1) {
+            const bool tooLong = std::exchange(overlong, false);
+            std::string line = pending.substr(start, newline - start);
+            if (!tooLong && (line.empty() || line == "\r")) {
+                continue;
+            }
+            const bool valid = !tooLong && sanitizeInput(line);
+            int gameId = MoveInbox::ANY_GAME;
+            if (valid && line.starts_with('#')) {
+                const auto [end, error] = std::from_chars(line.data() + 1, line.data() + line.size(), gameId);
+                if (error != std::errc() || gameId == MoveInbox::ANY_GAME) {
+                    continue;
+                }
+                line.erase(0, line.find_first_not_of(' ', end - line.data()));
+            }
+            inbox.deliver(gameId, valid && line == "STEAL" ? Move::STEAL : Move::SPLIT);
+        }
+        pending.erase(0, start);
+        //The start of a line which can not be valid anymore is dropped, its end is then read as a SPLIT
+        if (pending.size() > MAX_INPUT_LENGTH) {
+            pending.clear();
+            overlong = true;
+        }
+    }
+    return true;
+}
+
+/**
+ * Blocks until no game which 'inbox' was opened for is running anymore, so the socket of its connection can be closed
+ * safely. Only games of this connection count, games of the same user on an earlier connection do not
+ */
+void Server::waitForGames(const MoveInbox& inbox) {
+    std::unique_lock<std::mutex> lock(playingMutex);
+    cvPlaying.wait(lock, [&]() { return !inbox.isPlaying() || !running; });
+}
+
+/**
+ * Signs the client up for the tournament being formed and relays its moves until that tournament is over.
+ * Any waiting entrant starts the tournament once it is full or the first entrant waited 'tournaments.wait'.
+ * Returns false if the client disconnected, it then keeps its seat but loses the rest of its games
+ */
+bool Server::playTournament(const SOCKET clientSocket, const Username username, const int userId) {
+    const auto inbox = std::make_shared<MoveInbox>();
+    const auto outbox = std::make_shared<Outbox>(clientSocket);
+    outbox->attach();
+    std::shared_ptr<LiveTournament> tournament;
+    size_t seat;
+    {
+        std::lock_guard<std::mutex> lock(tournamentsMutex);
+        if (!formingTournament) {
+            formingTournament = std::make_shared<LiveTournament>();
+            formingTournament->id = nextTournamentId++;
+            formingTournament->formedAt = std::chrono::steady_clock::now();
+        }
+        tournament = formingTournament;
+        seat = tournament->entrants.size();
+        tournament->entrants.push_back({username, userId, outbox, nullptr, inbox});
+        outbox->post("Signed up for tournament #" + std::to_string(tournament->id) + " (" +
+                     std::to_string(seat + 1) + "/" + std::to_string(tournaments.players) +
+                     " players), it starts when full or at the latest " +
+                     std::to_string(tournaments.wait.count() / 1000) + " s after it was opened.\n");
+    }
+
+    const auto keepRelaying = [&]() {
+        {
+            std::lock_guard<std::mutex> lock(tournamentsMutex);
+            if (formingTournament == tournament) {
+                const bool full = (int)tournament->entrants.size() >= tournaments.players;
+                const bool due = std::chrono::steady_clock::now() >= tournament->formedAt + tournaments.wait &&
+                                 (tournament->entrants.size() >= 2 || !bots.empty());
+                if (full || due) {
+                    formingTournament = nullptr;
+                    startTournament(tournament);
+                }
+            }
+        }
+        std::lock_guard<std::mutex> lock(tournament->mutex);
+        return !tournament->over;
+    };
+    if (relayMoves(clientSocket, *inbox, *outbox, keepRelaying)) {
+        waitForGames(*inbox);
+        outbox->detach();
+        return true;
+    }
+    outbox->close();
+    waitForGames(*inbox);
+    return false;
+}
+
+/**
+ * Closes the entry list of 'tournament' (a bot joins a lone entrant), builds its bracket and launches the first round.
+ * Tournament games are played by 'tournamentRules', the first two player variant or the classic game if there is none.
+ * Called with 'tournamentsMutex' held
+ */
+void Server::startTournament(const std::shared_ptr<LiveTournament>& tournament) {
+    std::lock_guard<std::mutex> lock(tournament->mutex);
+    if (tournament->entrants.size() < 2) {
+        const BotPlayer& bot = bots[tournament->id % bots.size()];
+        tournament->entrants.push_back({bot.username, bot.userId, nullptr, bot.strategy, nullptr});
+    }
+    tournament->bracket = std::make_unique<Bracket>(tournaments.format, (int)tournament->entrants.size());
+    startTournamentRound(tournament);
+}
+
+/**
+ * Tells every entrant the standings so far, then launches all games of the next round at once,
+ * or marks the tournament as over if all rounds were played. Called with the tournament's mutex held
+ */
+void Server::startTournamentRound(const std::shared_ptr<LiveTournament>& tournament) {
+    Bracket& bracket = *tournament->bracket;
+    const std::vector<Participant>& entrants = tournament->entrants;
+    const std::string header = "Tournament #" + std::to_string(tournament->id) + ", ";
+
+    if (bracket.getRound() > 0) {
+        const auto standings = bracket.getStandings();
+        std::string top = header + "standings after round " + std::to_string(bracket.getRound()) + " of " +
+                          std::to_string(bracket.getRounds()) + ":\n";
+        std::vector<size_t> places(entrants.size());
+        for (size_t place = 0; place < standings.size(); place++) {
+            const Bracket::Standing& standing = standings[place];
+            places[standing.player] = place + 1;
+            if (place < 5) {
+                top += std::to_string(place + 1) + ". " + entrants[standing.player].username.str() + " " +
+                       std::to_string((int)standing.points) + (standing.points != (int)standing.points ? ".5" : "") +
+                       " points, " + std::to_string(standing.coins) + " coins\n";
+            }
+        }
+        const bool last = bracket.getRound() == bracket.getRounds();
+        for (size_t player = 0; player < entrants.size(); player++) {
+            if (!entrants[player].bot) {
+                entrants[player].outbox->post(top + "You are " + std::to_string(places[player]) + " of " +
+                                              std::to_string(entrants.size()) + ".\n" +
+                                              (last ? "The tournament is over.\n\n" : "\n"));
+            }
+        }
+    }
+
+    const auto pairings = bracket.nextRound();
+    if (pairings.empty()) {
+        tournament->over = true;
         return;
     }
+    const std::string round = header + "round " + std::to_string(bracket.getRound()) + " of " +
+                              std::to_string(bracket.getRounds());
+    tournament->gamesLeft = 0;
+    for (const auto& [first, second] : pairings) {
+        if (second == Bracket::BYE) {
+            GameSession::send(entrants[first], 0, round + ": you have a bye, it counts as a win.\n");
+        } else {
+            tournament->gamesLeft++;
+        }
+    }
+    for (const auto& [first, second] : pairings) {
+        if (second == Bracket::BYE) {
+            continue;
+        }
+        std::vector<Participant> table = {entrants[first], entrants[second]};
+        for (Participant& participant : table) {
+            GameSession::send(participant, 0, round + ".\n");
+            if (participant.bot) {
+                participant.bot = participant.bot->clone();
+            }
+        }
+        startGame(std::move(table), tournamentRules,
+                  [this, tournament, first, second](const std::vector<int>& scores) {
+                      reportTournamentGame(tournament, first, second, scores);
+                  });
+    }
+}
+
+//Records the result of one tournament game, the last game of a round pairs the next one
+void Server::reportTournamentGame(const std::shared_ptr<LiveTournament>& tournament, const int first, const int second,
+                                  const std::vector<int>& scores) {
+    std::lock_guard<std::mutex> lock(tournament->mutex);
+    tournament->bracket->report(first, second, scores[0], scores[1]);
+    if (--tournament->gamesLeft == 0) {
+        startTournamentRound(tournament);
+    }
+}
 
+//Games spectators can watch, one line per game: its id, players and how many watch it already
+std::string Server::listGames() {
+    std::string list;
+    std::lock_guard<std::mutex> lock(broadcastsMutex);
+    for (const auto& [gameId, broadcast] : broadcasts) {
+        if (!broadcast->isClosed()) {
+            list += "#" + std::to_string(gameId) + " " + broadcast->getTitle() + ", " +
+                    std::to_string(broadcast->getSpectators()) + " watching\n";
+        }
+    }
+    return list.empty() ? "No games in progress.\n" : "Games in progress (W <id> to watch):\n" + list;
+}
+
+/**
+ * Subscribes the client to the feed of 'gameId' and keeps writing what the game publishes until the game ends
+ * or the client sends "Q". The game itself writes without blocking, this thread only finishes writes
+ * the socket could not take at once. Returns false if the client disconnected meanwhile
+ */
+bool Server::watchGame(const SOCKET clientSocket, const int gameId) {
+    std::shared_ptr<Broadcast> broadcast;
     {
+        std::lock_guard<std::mutex> lock(broadcastsMutex);
+        if (const auto found = broadcasts.find(gameId); found != broadcasts.end()) {
+            broadcast = found->second;
+        }
+    }
+    if (!broadcast || broadcast->isClosed()) {
+        sendToClient(clientSocket, "No game in progress with id " + std::to_string(gameId) + ".\n");
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+        return true;
+    }
+    sendToClient(clientSocket, "Watching " + broadcast->getTitle() + ", send Q to stop.\n\n");
+    if (!broadcast->subscribe(clientSocket)) {
+        return true;
+    }
+
+    bool connected = true;
+    bool pending = true;
+    while (running && (pending || !broadcast->isClosed())) {
+        fd_set readable;
+        fd_set writable;
+        FD_ZERO(&readable);
+        FD_ZERO(&writable);
+        FD_SET(clientSocket, &readable);
+        if (pending) {
+            FD_SET(clientSocket, &writable);
+        }
+        timeval timeout = {0, 200000};
+        if (select((int)clientSocket + 1, &readable, &writable, nullptr, &timeout) < 0) {
+            connected = false;
+            break;
+        }
+        if (FD_ISSET(clientSocket, &readable)) {
+            std::string received = receiveFromClient(clientSocket);
+            if (received.empty()) {
+                connected = false;
+                break;
+            }
+            if (sanitizeInput(received) && received == "Q") {
+                break;
+            }
+        }
+        pending = broadcast->flush(clientSocket);
+    }
+    broadcast->unsubscribe(clientSocket);
+    return connected;
+}
+
+/**
+ * Serves a client which chose the binary protocol (see BinaryProtocol.h). Requests are answered one frame each,
+ * before login only REGISTER, LOGIN and RESUME are accepted. QUEUE goes through the same matchmaking queues and
+ * games as the text menu, with a tagged inbox since every MOVE names its game, and returns once all those games ended.
+ * Tournaments and watching games are left to the text dialogue. A malformed frame ends the connection
+ */
+void Server::binaryClientLoop(const SOCKET clientSocket, const std::string& clientAddress) {
+    FrameReceiver frames;
+    FrameWriter reply;
+    const auto outbox = std::make_shared<Outbox>(clientSocket);
+    Username username;
+    int userId = 0;
+    const auto refuse = [&](const std::string_view reason) {
+        reply.begin(FrameType::REFUSED).putString(reason).sendTo(*outbox);
+    };
+    //STANDINGS with the top rows (at most 20) and the client's own row
+    const auto standings = [&](FrameReader& request) {
+        const int rows = std::clamp<int>(request.get8(), 1, 20);
+        const auto top = matchDAO->getTopPlayers(rows);
+        reply.begin(FrameType::STANDINGS).put8((uint8_t)top.size());
+        for (const auto& [name, average] : top) {
+            reply.putString(name).putDouble(average);
+        }
+        const auto [name, average] = matchDAO->getAverageScore(userId);
+        reply.putString(name).putDouble(average).sendTo(*outbox);
+    };
+    //While the client plays, LEADERBOARD is answered between the game frames and other requests are refused
+    const auto playingRequest = [&](FrameReader& request) {
+        if (request.getType() == FrameType::LEADERBOARD) {
+            standings(request);
+        } else {
+            refuse("unexpected frame while playing: " + std::to_string((int)request.getType()) + "\n");
+        }
+    };
+    const auto loggedIn = [&](const ServerAuthenticator::LoginResult& result) {
+        if (result.username.empty()) {
+            refuse(result.message);
+            return;
+        }
+        username = result.username;
+        userId = result.userId;
+        reply.begin(FrameType::LOGGED_IN).put32((uint32_t)userId).putString(result.token).sendTo(*outbox);
+    };
+
+    reply.begin(FrameType::WELCOME).put8(BINARY_PROTOCOL_VERSION).sendTo(*outbox);
+    try {
+        while (running) {
+            std::optional<FrameReader> request = frames.next();
+            if (!request) {
+                const std::string received = receiveFromClient(clientSocket);
+                if (received.empty()) {
+                    break;
+                }
+                frames.feed(received);
+                continue;
+            }
+            const FrameType type = request->getType();
+            if (type == FrameType::EXIT) {
+                break;
+            }
+            if (username.empty() && (type == FrameType::REGISTER || type == FrameType::LOGIN ||
+                                     type == FrameType::RESUME)) {
+                //Strings pass the same validation as lines of the text dialogue
+                std::string first = request->getString();
+                std::string second = type == FrameType::RESUME ? std::string() : request->getString();
+                const bool valid = sanitizeInput(first) && (type == FrameType::RESUME || sanitizeInput(second));
+                if (!authenticator->allowAttempt(clientAddress)) {
+                    refuse(ServerAuthenticator::RATE_LIMITED_MESSAGE);
+                } else if (!valid) {
+                    refuse("Invalid input.\n");
+                } else if (type == FrameType::REGISTER) {
+                    reply.begin(FrameType::NOTICE).putString(authenticator->registerUser(first, second, second))
+                         .sendTo(*outbox);
+                } else if (type == FrameType::LOGIN) {
+                    loggedIn(authenticator->login(first, second, activeUsersMutex, activeUsers));
+                } else {
+                    loggedIn(authenticator->resume(first, activeUsersMutex, activeUsers));
+                }
+            } else if (username.empty()) {
+                refuse("Log in first.\n");
+            } else if (type == FrameType::QUEUE) {
+                const int games = request->get8();
+                std::string variantName = request->getString();
+                if (variantName.empty()) {
+                    variantName = variants.front()->getName();
+                }
+                const auto found = std::ranges::find_if(variants, [&](const auto& rules) {
+                    return rules->getName() == variantName;
+                });
+                if (found == variants.end() || games < 1 || games > MAX_GAMES_PER_CLIENT) {
+                    refuse(found == variants.end() ? "unknown game variant: " + variantName + "\n"
+                                                   : "number of games must be within 1-" +
+                                                     std::to_string(MAX_GAMES_PER_CLIENT) + "\n");
+                    continue;
+                }
+                const auto inbox = std::make_shared<MoveInbox>(true);
+                outbox->attach();
+                const auto [timedOut, seated] = joinQueue({username, userId, outbox, {}, inbox, true},
+                                                          found - variants.begin(), games);
+                if (timedOut) {
+                    reply.begin(FrameType::QUEUE_TIMEOUT).sendTo(*outbox);
+                }
+                const auto playing = [&]() { return inbox->isPlaying(); };
+                if (seated && !relayMoves(clientSocket, *inbox, *outbox, playing, &frames, playingRequest)) {
+                    outbox->close();
+                    waitForGames(*inbox);
+                    break;
+                }
+                outbox->detach();
+            } else if (type == FrameType::LEADERBOARD) {
+                standings(*request);
+            } else if (type != FrameType::MOVE) {
+                //A MOVE which arrives after its game ended is dropped rather than refused
+                refuse("unexpected frame: " + std::to_string((int)type) + "\n");
+            }
+        }
+    } catch (const std::runtime_error&) {
+        //Malformed frame, the client is disconnected like a client which hung up
+    }
+
+    if (!username.empty()) {
         std::lock_guard<std::mutex> lock(activeUsersMutex);
-        activeUsers.insert(username);
+        activeUsers.erase(username);
+    }
+}
+
+/**
+ * Starts with loginRegistrationPhase, if client logs in successfully, its username is already stored in 'activeUsers'
+ * so while logged in, no other client can log in using the same account
+ * Login attempts are rate limited per remote address of the client
+ * A client which opens with the binary hello is served by 'binaryClientLoop' instead
+ */
+void Server::handleClient(const SOCKET clientSocket) {
+    const std::string clientAddress = peerAddress(clientSocket);
+    if (const auto version = negotiateBinary(clientSocket, std::chrono::milliseconds(10),
+                                             std::chrono::milliseconds(100))) {
+        if (*version == BINARY_PROTOCOL_VERSION) {
+            binaryClientLoop(clientSocket, clientAddress);
+        } else {
+            Outbox outbox(clientSocket);
+            FrameWriter refusal;
+            refusal.begin(FrameType::REFUSED).putString("unsupported protocol version " + std::to_string(*version) +
+                                                        ", this server speaks " +
+                                                        std::to_string(BINARY_PROTOCOL_VERSION) + "\n");
+            refusal.sendTo(outbox);
+        }
+        closesocket(clientSocket);
+        return;
+    }
+    const auto [username, userId] = authenticator->loginRegistrationPhase(clientSocket, clientAddress,
+                                                                          activeUsersMutex, activeUsers);
+    if (username.empty()) {
+        closesocket(clientSocket);
+        return;
     }
 
-    mainMenuLoop(clientSocket, username);
+    mainMenuLoop(clientSocket, username, userId);
 
     closesocket(clientSocket);
     {
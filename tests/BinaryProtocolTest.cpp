@@ -0,0 +1,136 @@
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "AuthHandler.h"
+#include "BinaryProtocol.h"
+#include "HelperFunctions.h"
+#include "InMemoryMatchDao.h"
+#include "InMemoryUserDao.h"
+#include "LengthChecker.h"
+#include "Server.h"
+#include "ServerAuthenticator.h"
+#include "SessionManager.h"
+
+/**
+ * Plays one game of the binary protocol against a bot on an in-memory server and sends LEADERBOARD in the middle
+ * of it, right in front of a MOVE. The server has to answer STANDINGS between the game frames and still take
+ * the MOVE behind the request, so the game reaches GAME_OVER. Exits with 1 and the reason if it does not.
+ *
+ * Usage: BinaryProtocolTest [port]
+ */
+namespace {
+    //Next frame from 'socket', std::nullopt if the connection closed or 'deadline' passed
+    std::optional<FrameReader> nextFrame(const SOCKET socket, FrameReceiver& frames,
+                                         const std::chrono::steady_clock::time_point deadline) {
+        while (std::chrono::steady_clock::now() < deadline) {
+            if (std::optional<FrameReader> frame = frames.next()) {
+                return frame;
+            }
+            fd_set readable;
+            FD_ZERO(&readable);
+            FD_SET(socket, &readable);
+            timeval timeout = {0, 100000};
+            if (select((int)socket + 1, &readable, nullptr, nullptr, &timeout) <= 0) {
+                continue;
+            }
+            const std::string received = receiveFromClient(socket);
+            if (received.empty()) {
+                return std::nullopt;
+            }
+            frames.feed(received);
+        }
+        return std::nullopt;
+    }
+
+    //Logs in as a new user and plays one game, returns what went wrong or an empty string
+    std::string playWithLeaderboard(const int port) {
+        const SOCKET client = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+        sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        inet_pton(AF_INET, "127.0.0.1", &address.sin_addr);
+        address.sin_port = htons(port);
+        if (connect(client, (sockaddr*)(&address), sizeof(address)) == SOCKET_ERROR) {
+            return "could not connect";
+        }
+        Outbox outbox(client);
+        FrameReceiver frames;
+        FrameWriter request;
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(20);
+        const auto expect = [&](const FrameType type) {
+            const std::optional<FrameReader> frame = nextFrame(client, frames, deadline);
+            return frame && frame->getType() == type;
+        };
+
+        std::string hello(BINARY_HELLO.begin(), BINARY_HELLO.end());
+        hello += (char)BINARY_PROTOCOL_VERSION;
+        outbox.post(hello);
+        request.begin(FrameType::REGISTER).putString("tester").putString("Password1").sendTo(outbox);
+        request.begin(FrameType::LOGIN).putString("tester").putString("Password1").sendTo(outbox);
+        if (!expect(FrameType::WELCOME) || !expect(FrameType::NOTICE) || !expect(FrameType::LOGGED_IN)) {
+            closesocket(client);
+            return "login failed";
+        }
+
+        request.begin(FrameType::QUEUE).put8(1).putString("").sendTo(outbox);
+        bool standings = false;
+        std::string failure = "no GAME_OVER";
+        while (std::optional<FrameReader> frame = nextFrame(client, frames, deadline)) {
+            if (frame->getType() == FrameType::STANDINGS) {
+                standings = true;
+            } else if (frame->getType() == FrameType::MOVE_REQUEST) {
+                const uint32_t gameId = frame->get32();
+                if (frame->get16() == 1) {
+                    request.begin(FrameType::LEADERBOARD).put8(5).sendTo(outbox);
+                }
+                request.begin(FrameType::MOVE).put32(gameId).put8(1).sendTo(outbox);
+            } else if (frame->getType() == FrameType::GAME_OVER) {
+                failure = standings ? "" : "no STANDINGS during the game";
+                break;
+            } else if (frame->getType() == FrameType::REFUSED) {
+                failure = "request refused: " + frame->getString();
+                break;
+            }
+        }
+        request.begin(FrameType::EXIT).sendTo(outbox);
+        closesocket(client);
+        return failure;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    const int port = argc > 1 ? std::stoi(argv[1]) : 54001;
+
+    const auto userDao = std::make_shared<InMemoryUserDAO>();
+    const auto passwordHasher = std::make_shared<PasswordHasher>(1);
+    const auto authHandler = std::make_shared<AuthHandler>(userDao, std::make_shared<LengthChecker>(8), passwordHasher,
+                                                           std::make_shared<HashingPool>(1, 16));
+    const auto usernames = std::make_shared<UsernameTable>();
+    const auto authenticator = std::make_shared<ServerAuthenticator>(
+        authHandler, std::make_shared<SessionManager>("test secret", std::chrono::seconds(60)), nullptr, nullptr,
+        usernames);
+    const int botId = userDao->addUser(User("bot:TFT", passwordHasher->hash("unused")));
+    std::vector<BotPlayer> bots = {{usernames->intern("bot:TFT"), botId, makeStrategy("TFT")}};
+
+    std::string failure;
+    {
+        Server server("127.0.0.1", port, authenticator, std::make_shared<InMemoryMatchDAO>(userDao), std::move(bots),
+                      std::chrono::milliseconds(0));
+        std::thread serverThread(&Server::start, &server);
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        failure = playWithLeaderboard(port);
+        server.stop();
+        serverThread.join();
+    }
+
+    if (!failure.empty()) {
+        std::cerr << "LEADERBOARD during a game: " << failure << std::endl;
+        return 1;
+    }
+    std::cout << "LEADERBOARD during a game: ok" << std::endl;
+    return 0;
+}
@@ -0,0 +1,76 @@
+#include <algorithm>
+#include <iostream>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Bracket.h"
+
+/**
+ * Plays whole brackets of 2 to 33 entrants in both formats, reporting made up results, and checks after every round
+ * that each entrant is in exactly one pairing and that a bye goes to somebody who has not had one yet
+ * (while there is such an entrant). Round-robin must pair every two entrants exactly once over all its rounds.
+ * Exits with 1 and the first broken invariant.
+ */
+namespace {
+    //Returns the first broken invariant of a whole tournament of 'players' in 'format', or an empty string
+    std::string play(const Bracket::Format format, const int players) {
+        Bracket bracket(format, players);
+        std::multiset<std::pair<int, int>> met;
+        std::vector<bool> hadBye(players, false);
+        int byes = 0;
+
+        for (std::vector<std::pair<int, int>> pairings; !(pairings = bracket.nextRound()).empty();) {
+            const std::string round = "round " + std::to_string(bracket.getRound()) + ": ";
+            std::vector<int> seen(players, 0);
+            for (const auto& [first, second] : pairings) {
+                seen[first]++;
+                if (second == Bracket::BYE) {
+                    if (hadBye[first] && byes < players) {
+                        return round + "second bye for entrant " + std::to_string(first);
+                    }
+                    hadBye[first] = true;
+                    byes++;
+                    continue;
+                }
+                seen[second]++;
+                met.insert(std::minmax(first, second));
+                //Made up coins, so standings and the next Swiss pairings change from round to round
+                bracket.report(first, second, (first * 7 + second * 3 + bracket.getRound()) % 5, (first + second) % 4);
+            }
+            for (int player = 0; player < players; player++) {
+                if (seen[player] != 1) {
+                    return round + "entrant " + std::to_string(player) + " is in " + std::to_string(seen[player]) +
+                           " pairings";
+                }
+            }
+        }
+
+        if (format == Bracket::Format::ROUND_ROBIN) {
+            for (int first = 0; first < players; first++) {
+                for (int second = first + 1; second < players; second++) {
+                    if (met.count({first, second}) != 1) {
+                        return "entrants " + std::to_string(first) + " and " + std::to_string(second) + " met " +
+                               std::to_string(met.count({first, second})) + " times";
+                    }
+                }
+            }
+        }
+        return "";
+    }
+}
+
+int main() {
+    for (const auto& [format, name] : {std::pair{Bracket::Format::ROUND_ROBIN, "round-robin"},
+                                       std::pair{Bracket::Format::SWISS, "swiss"}}) {
+        for (int players = 2; players <= 33; players++) {
+            if (const std::string failure = play(format, players); !failure.empty()) {
+                std::cerr << "Bracket " << name << " of " << players << ": " << failure << std::endl;
+                return 1;
+            }
+        }
+    }
+    std::cout << "Bracket pairings: ok" << std::endl;
+    return 0;
+}
@@ -0,0 +1,43 @@
+#include <iostream>
+#include <string>
+#include <string_view>
+
+#include "CharClassScanner.h"
+
+/**
+ * Compares 'scanCharClasses' (SSE2 where the target has it) with 'scanCharClassesScalar' for every byte value
+ * in texts of 0 to 40 bytes: a text made only of that byte, and the byte at every position of a text of spaces
+ * (which have no class), so it lands in the vectorized part as well as in the tail.
+ * Exits with 1 and the first text on which they differ.
+ */
+namespace {
+    //Returns a description of 'text' if both scans disagree on it, an empty string otherwise.
+    //'position' is where 'byte' is in 'text', -1 if 'text' is made only of it
+    std::string compare(const std::string_view text, const int byte, const int position) {
+        if (scanCharClasses(text) == scanCharClassesScalar(text)) {
+            return "";
+        }
+        const std::string where = position < 0 ? " everywhere" : " at position " + std::to_string(position);
+        return "byte " + std::to_string(byte) + where + " of " + std::to_string(text.size()) + " bytes";
+    }
+}
+
+int main() {
+    for (int length = 0; length <= 40; length++) {
+        for (int byte = 0; byte < 256; byte++) {
+            std::string failure = compare(std::string(length, (char)byte), byte, -1);
+            std::string text(length, ' ');
+            for (int position = 0; position < length && failure.empty(); position++) {
+                text[position] = (char)byte;
+                failure = compare(text, byte, position);
+                text[position] = ' ';
+            }
+            if (!failure.empty()) {
+                std::cerr << "scanCharClasses differs from the scalar scan: " << failure << std::endl;
+                return 1;
+            }
+        }
+    }
+    std::cout << "scanCharClasses: ok" << std::endl;
+    return 0;
+}
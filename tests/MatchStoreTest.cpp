@@ -0,0 +1,103 @@
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include "Database.h"
+#include "JournalMatchDao.h"
+#include "SqliteMatchDao.h"
+#include "SqliteUserDao.h"
+
+/**
+ * Stores a match with moves, seed and variant through SqliteMatchDAO and through JournalMatchDAO and reads it back:
+ * from the journal after it was closed and opened again, and by the same id once the journal was exported.
+ * Works on a fresh database and journal in the temporary directory.
+ * Exits with 1 and the first mismatch if a stored match does not come back as it went in.
+ */
+namespace {
+    //A match of 7 rounds, so the last byte of its moves is only partly used
+    Match makeMatch(const int user1Id, const int user2Id, const uint64_t seed) {
+        MoveLog moves;
+        for (int round = 0; round < 7; round++) {
+            moves.record(round % 2 == 0 ? Move::SPLIT : Move::STEAL, round % 3 == 0 ? Move::STEAL : Move::SPLIT);
+        }
+        return {user1Id, 2.5, user2Id, 1.75, moves, seed, "noisy", 2};
+    }
+
+    //Returns what 'dao' returns differently from 'match' for 'matchId' or an empty string
+    std::string compare(const MatchDAO& dao, const int matchId, const Match& match) {
+        const MoveLog moves = dao.getMoveLog(matchId);
+        if (moves.getRounds() != match.getMoves().getRounds() || moves.getBytes() != match.getMoves().getBytes()) {
+            return "moves differ";
+        }
+        if (dao.getSeed(matchId) != match.getSeed()) {
+            return "seed differs";
+        }
+        if (dao.getVariant(matchId) != std::make_pair(match.getVariant(), match.getPlayers())) {
+            return "variant differs";
+        }
+        if (dao.getScores(matchId) != std::make_pair(match.getScore1(), match.getScore2())) {
+            return "scores differ";
+        }
+        return "";
+    }
+
+    std::string roundTrips(const std::filesystem::path& directory) {
+        const std::string journalPath = (directory / "matches.journal").string();
+        const auto database = std::make_shared<Database>((directory / "database.sqlite").string());
+        const auto userDao = std::make_shared<SqliteUserDAO>(database);
+        const int user1Id = userDao->addUser(User("alice", "unused"));
+        const int user2Id = userDao->addUser(User("bob", "unused"));
+        const auto archive = std::make_shared<SqliteMatchDAO>(database);
+
+        const Match stored = makeMatch(user1Id, user2Id, 1234567890123ULL);
+        if (const std::string failure = compare(*archive, archive->addMatch(stored), stored); !failure.empty()) {
+            return "SqliteMatchDAO: " + failure;
+        }
+
+        const Match journaled = makeMatch(user2Id, user1Id, 0xFEDCBA9876543210ULL);
+        int journaledId;
+        {
+            const JournalMatchDAO journal(journalPath, userDao, archive);
+            journaledId = journal.addMatch(journaled);
+        }
+        {
+            JournalMatchDAO journal(journalPath, userDao, archive);
+            if (const std::string failure = compare(journal, journaledId, journaled); !failure.empty()) {
+                return "JournalMatchDAO after reopening: " + failure;
+            }
+            if (journal.exportToArchive() != 1) {
+                return "JournalMatchDAO did not export its match";
+            }
+            if (const std::string failure = compare(journal, journaledId, journaled); !failure.empty()) {
+                return "JournalMatchDAO after export: " + failure;
+            }
+        }
+        if (const std::string failure = compare(*archive, journaledId, journaled); !failure.empty()) {
+            return "exported match in SqliteMatchDAO: " + failure;
+        }
+        return "";
+    }
+}
+
+int main() {
+    const std::filesystem::path directory = std::filesystem::temp_directory_path() / "MatchStoreTest";
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+
+    std::string failure;
+    try {
+        failure = roundTrips(directory);
+    } catch (const std::exception& e) {
+        failure = e.what();
+    }
+    std::filesystem::remove_all(directory);
+
+    if (!failure.empty()) {
+        std::cerr << "Match round trip: " << failure << std::endl;
+        return 1;
+    }
+    std::cout << "Match round trip: ok" << std::endl;
+    return 0;
+}
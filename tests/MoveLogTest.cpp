@@ -0,0 +1,58 @@
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "MoveLog.h"
+
+/**
+ * Records matches of 0 to 17 rounds into a MoveLog, so every fill of the last packed byte is covered,
+ * and reads every round back both from the log itself and from a log decoded from its bytes.
+ * Exits with 1 and the first mismatch if a round does not come back as it was recorded.
+ */
+namespace {
+    //Moves of round 'round' of a made up match, all four combinations turn up within any four rounds
+    std::pair<Move, Move> movesOf(const int round) {
+        return {round % 2 == 0 ? Move::SPLIT : Move::STEAL, round % 4 < 2 ? Move::STEAL : Move::SPLIT};
+    }
+
+    //Returns what is wrong with 'log' holding 'rounds' rounds of the made up match or an empty string
+    std::string checkLog(const MoveLog& log, const int rounds) {
+        if (log.getRounds() != rounds) {
+            return "has " + std::to_string(log.getRounds()) + " rounds";
+        }
+        if (log.getBytes().size() != (size_t)(rounds + 3) / 4) {
+            return "takes " + std::to_string(log.getBytes().size()) + " bytes";
+        }
+        for (int round = 0; round < rounds; round++) {
+            if (log.getRound(round) != movesOf(round)) {
+                return "round " + std::to_string(round) + " differs";
+            }
+        }
+        return "";
+    }
+}
+
+int main() {
+    for (int rounds = 0; rounds <= 17; rounds++) {
+        MoveLog log;
+        for (int round = 0; round < rounds; round++) {
+            const auto [move1, move2] = movesOf(round);
+            log.record(move1, move2);
+        }
+
+        std::string failure = checkLog(log, rounds);
+        if (failure.empty()) {
+            failure = checkLog(MoveLog(log.getBytes(), rounds), rounds);
+            if (!failure.empty()) {
+                failure = "decoded log " + failure;
+            }
+        }
+        if (!failure.empty()) {
+            std::cerr << "MoveLog of " << rounds << " rounds: " << failure << std::endl;
+            return 1;
+        }
+    }
+    std::cout << "MoveLog record/getRound: ok" << std::endl;
+    return 0;
+}
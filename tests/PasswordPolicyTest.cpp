@@ -0,0 +1,63 @@
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "PasswordPolicy.h"
+#include "RuntimePasswordPolicy.h"
+
+/**
+ * Checks that RuntimePasswordPolicy built from a spec gives the same verdict as the PasswordPolicy with the same
+ * rules in the same order, for every password of up to 5 characters (and the same passwords doubled, to get past
+ * the length rules) made of a lower-case letter, an upper-case letter, a digit, a symbol and a non-ASCII byte.
+ * Exits with 1 and the first password on which they differ.
+ */
+namespace {
+    std::vector<std::string> passwords() {
+        constexpr std::string_view alphabet = "aA1!\xC3";
+        std::vector<std::string> result = {""};
+        for (size_t from = 0, to = result.size(); result.back().size() < 5; from = to, to = result.size()) {
+            for (size_t i = from; i < to; i++) {
+                for (const char c : alphabet) {
+                    result.push_back(result[i] + c);
+                }
+            }
+        }
+        for (size_t i = 0, count = result.size(); i < count; i++) {
+            result.push_back(result[i] + result[i]);
+        }
+        return result;
+    }
+
+    //Returns what went wrong when comparing 'Policy' with the policy built from 'spec' or an empty string
+    template <typename Policy>
+    std::string compare(const std::string& spec, const std::vector<std::string>& passwords) {
+        const RuntimePasswordPolicy runtimePolicy(spec);
+        for (const std::string& password : passwords) {
+            if (runtimePolicy.verdict(password) != Policy::check(password)) {
+                return spec + " differs for \"" + password + "\": \"" + std::string(runtimePolicy.verdict(password)) +
+                       "\" instead of \"" + std::string(Policy::check(password)) + "\"";
+            }
+        }
+        return "";
+    }
+}
+
+int main() {
+    const std::vector<std::string> all = passwords();
+    const std::string failures[] = {
+        compare<PasswordPolicy<MinLength<8>, RequireUpperCase, RequireLowerCase>>("length=8,upper,lower", all),
+        compare<PasswordPolicy<RequireDigit, RequireSymbol, MinLength<3>>>("digit,symbol,length=3", all),
+        compare<PasswordPolicy<MinClasses<3>, MinLength<6>>>("classes=3,length=6", all),
+        compare<PasswordPolicy<RequireLowerCase, MinClasses<2>, RequireUpperCase, RequireDigit, RequireSymbol>>(
+            "lower,classes=2,upper,digit,symbol", all),
+    };
+    for (const std::string& failure : failures) {
+        if (!failure.empty()) {
+            std::cerr << "RuntimePasswordPolicy: " << failure << std::endl;
+            return 1;
+        }
+    }
+    std::cout << "RuntimePasswordPolicy: ok" << std::endl;
+    return 0;
+}
@@ -0,0 +1,65 @@
+#include <chrono>
+#include <iostream>
+#include <string>
+
+#include "RateLimiter.h"
+
+/**
+ * Drives a RateLimiter through a clock the test moves by hand: a key gets its burst at once and is refused after it,
+ * gets one more attempt per interval, does not touch other keys, and its bucket is swept once it stayed idle.
+ * Exits with 1 and the first step which went wrong.
+ */
+namespace {
+    std::string limits() {
+        RateLimiter::Clock::time_point now;
+        const auto advance = [&](const std::chrono::milliseconds by) { now += by; };
+        RateLimiter limiter(3, std::chrono::seconds(1), std::chrono::seconds(10), [&]() { return now; });
+
+        for (int attempt = 0; attempt < 3; attempt++) {
+            if (!limiter.tryAcquire("alice")) {
+                return "attempt " + std::to_string(attempt + 1) + " of the burst refused";
+            }
+        }
+        if (limiter.tryAcquire("alice")) {
+            return "attempt after the burst allowed";
+        }
+        if (!limiter.tryAcquire("bob")) {
+            return "another key refused";
+        }
+
+        advance(std::chrono::milliseconds(999));
+        if (limiter.tryAcquire("alice")) {
+            return "attempt allowed before the interval passed";
+        }
+        advance(std::chrono::milliseconds(1));
+        if (!limiter.tryAcquire("alice")) {
+            return "attempt refused after the interval";
+        }
+        if (limiter.tryAcquire("alice")) {
+            return "second attempt allowed within one interval";
+        }
+
+        //Once idle for longer than 'idleTimeout' the old buckets are dropped while new keys reach every shard
+        advance(std::chrono::seconds(30));
+        constexpr int newKeys = 256;
+        for (int key = 0; key < newKeys; key++) {
+            limiter.tryAcquire("key" + std::to_string(key));
+        }
+        if (limiter.size() != newKeys) {
+            return "idle buckets not swept, " + std::to_string(limiter.size()) + " buckets left";
+        }
+        if (!limiter.tryAcquire("alice") || !limiter.tryAcquire("alice") || !limiter.tryAcquire("alice")) {
+            return "swept key did not get its burst again";
+        }
+        return "";
+    }
+}
+
+int main() {
+    if (const std::string failure = limits(); !failure.empty()) {
+        std::cerr << "RateLimiter: " << failure << std::endl;
+        return 1;
+    }
+    std::cout << "RateLimiter: ok" << std::endl;
+    return 0;
+}
@@ -0,0 +1,55 @@
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "BlocklistFilter.h"
+
+/**
+ * Builds the filter file used by the server's '--blocklist' option from a plain text list of passwords,
+ * one per line (e.g. a breached password corpus). The input is streamed twice, once to count entries
+ * and once to insert them, so only the filter itself is held in memory.
+ *
+ * Usage: BuildBlocklist <passwords.txt> <output filter> [bitsPerEntry = 10]
+ */
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0] << " <passwords.txt> <output filter> [bitsPerEntry]" << std::endl;
+        return 1;
+    }
+    const std::string inputPath = argv[1];
+    const std::string outputPath = argv[2];
+    const double bitsPerEntry = argc > 3 ? std::stod(argv[3]) : 10.0;
+
+    std::ifstream input(inputPath);
+    if (!input) {
+        std::cerr << "Failed to open " << inputPath << std::endl;
+        return 1;
+    }
+
+    uint64_t entries = 0;
+    std::string line;
+    while (std::getline(input, line)) {
+        entries++;
+    }
+
+    BlocklistFilterBuilder builder(entries, bitsPerEntry);
+    input.clear();
+    input.seekg(0);
+    while (std::getline(input, line)) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if (!line.empty()) {
+            builder.add(line);
+        }
+    }
+
+    try {
+        builder.save(outputPath);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    std::cout << "Wrote " << entries << " passwords to " << outputPath << std::endl;
+    return 0;
+}
@@ -0,0 +1,31 @@
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "HelperFunctions.h"
+#include "Tournament.h"
+
+/**
+ * Runs a round-robin tournament between all built-in strategies of the headless game kernel
+ * and prints their ranking (average coins per round) in the same table the server shows as its leaderboard.
+ *
+ * Usage: Tournament [rounds = 200] [repetitions = 10000] [threads = all cores] [seed = 0]
+ */
+int main(int argc, char* argv[]) {
+    const int rounds = argc > 1 ? std::stoi(argv[1]) : 200;
+    const int repetitions = argc > 2 ? std::stoi(argv[2]) : 10000;
+    const int threads = argc > 3 ? std::stoi(argv[3]) : (int)std::max(1u, std::thread::hardware_concurrency());
+    const uint64_t seed = argc > 4 ? std::stoull(argv[4]) : 0;
+
+    const Tournament tournament(builtinStrategies(), rounds, repetitions, seed);
+
+    const auto start = std::chrono::steady_clock::now();
+    const auto ranking = tournament.run(threads);
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << makeTable(ranking);
+    std::cout << tournament.getMatchCount() << " matches of " << rounds << " rounds on " << threads << " threads in "
+              << seconds << " s (" << (long long)(tournament.getMatchCount() / seconds) << " matches/s)" << std::endl;
+    return 0;
+}